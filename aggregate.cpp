@@ -0,0 +1,158 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "aggregate.h"
+#include "pathstr.h"
+#include <QtAlgorithms>
+
+namespace pathstr {
+PathAggregator::PathAggregator()
+    : m_extensions(PathKey::Exact)
+{}
+
+void PathAggregator::add(QStringView path, qint64 value)
+{
+    m_total.add(value);
+    m_rolledUp = false;
+
+    ExtensionStats &ext = m_extensionStats[extensionIndex(lowerCompleteSuffixView(path, m_lowerBuffer))];
+    ext.add(value);
+    ++ext.histogram[histogramBucket(value)];
+
+    const PathTree::Handle folder = m_folders.insert(parentFolderView(path));
+    if (folder == PathTree::s_none)
+        return;
+
+    if (m_direct.size() <= size_t(folder))
+        m_direct.resize(m_folders.size());
+
+    m_direct[folder].add(value);
+}
+
+void PathAggregator::merge(const PathAggregator &other)
+{
+    m_total.add(other.m_total);
+    m_rolledUp = false;
+
+    for (int i = 0; i < other.extensionCount(); ++i) {
+        const ExtensionStats &from = other.m_extensionStats[i];
+        ExtensionStats &to = m_extensionStats[extensionIndex(other.m_extensions.path(i))];
+
+        to.add(from);
+        for (int bucket = 0; bucket < s_histogramBuckets; ++bucket)
+            to.histogram[bucket] += from.histogram[bucket];
+    }
+
+    // the parents come before their children, so each one is mapped when its children are
+    std::vector<PathTree::Handle> mapped(other.m_folders.size());
+    m_direct.reserve(m_folders.size() + other.m_folders.size());
+
+    for (PathTree::Handle node = 0; node < other.m_folders.size(); ++node) {
+        const PathTree::Handle parent = other.m_folders.parent(node);
+        const PathTree::Handle folder = m_folders.insertChild((parent == PathTree::s_none) ? PathTree::s_none : mapped[parent],
+                                                              other.m_folders.entryName(node));
+        mapped[node] = folder;
+
+        if (m_direct.size() <= size_t(folder))
+            m_direct.resize(m_folders.size());
+
+        if (size_t(node) < other.m_direct.size())
+            m_direct[folder].add(other.m_direct[node]);
+    }
+}
+
+AggregateStats PathAggregator::total() const
+{
+    return m_total;
+}
+
+/*** Extensions ***/
+int PathAggregator::extensionIndex(QStringView lowerExt)
+{
+    const int found = m_extensions.find(lowerExt);
+    if (found != -1)
+        return found;
+
+    m_extensionStats.emplace_back();
+    return m_extensions.insert(lowerExt.toString());
+}
+
+int PathAggregator::extensionCount() const
+{
+    return m_extensions.size();
+}
+
+QString PathAggregator::extensionName(int index) const
+{
+    return m_extensions.path(index);
+}
+
+const ExtensionStats &PathAggregator::extensionStats(int index) const
+{
+    return m_extensionStats[index];
+}
+
+ExtensionStats PathAggregator::extension(QStringView ext) const
+{
+    if (ext.startsWith(u'.'))
+        ext = ext.mid(1);
+
+    const int index = m_extensions.find(ext.toString().toLower());
+    return (index == -1) ? ExtensionStats() : m_extensionStats[index];
+}
+
+int PathAggregator::histogramBucket(qint64 value)
+{
+    return (value > 0) ? 64 - int(qCountLeadingZeroBits(quint64(value))) : 0;
+}
+
+/*** Folders ***/
+const PathTree &PathAggregator::folders() const
+{
+    return m_folders;
+}
+
+AggregateStats PathAggregator::direct(PathTree::Handle folder) const
+{
+    return (folder >= 0 && size_t(folder) < m_direct.size()) ? m_direct[folder] : AggregateStats();
+}
+
+void PathAggregator::rollUp()
+{
+    m_recursive = sumUp();
+    m_rolledUp = true;
+}
+
+AggregateStats PathAggregator::recursive(PathTree::Handle folder) const
+{
+    if (folder < 0 || folder >= m_folders.size())
+        return AggregateStats();
+
+    return m_rolledUp ? m_recursive[folder] : sumUp()[folder];
+}
+
+// The children come after their parents: a pass backwards adds each finished folder to its parent
+std::vector<AggregateStats> PathAggregator::sumUp() const
+{
+    std::vector<AggregateStats> recursive = m_direct;
+    recursive.resize(m_folders.size());
+
+    for (PathTree::Handle node = m_folders.size() - 1; node >= 0; --node) {
+        const PathTree::Handle parent = m_folders.parent(node);
+        if (parent != PathTree::s_none)
+            recursive[parent].add(recursive[node]);
+    }
+
+    return recursive;
+}
+
+} // namespace pathstr
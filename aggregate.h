@@ -0,0 +1,118 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include "pathkey.h"
+#include "pathtree.h"
+#include <vector>
+
+namespace pathstr {
+// The number and the sum of the values
+struct AggregateStats
+{
+    qint64 count = 0;
+    qint64 total = 0;
+
+    void add(qint64 value) { ++count; total += value; }
+    void add(const AggregateStats &other) { count += other.count; total += other.total; }
+};
+
+// The values by their bit width: 0, 1, 2-3, 4-7, ..., 2^62 and more; the negative ones are in 0
+static const int s_histogramBuckets = 64;
+
+struct ExtensionStats : AggregateStats
+{
+    qint64 histogram[s_histogramBuckets] = {};
+};
+
+/* Groups (path, value) pairs, e.g. the files of an inventory with their sizes, in one pass:
+ * per extension (the lower-case completeSuffix()) the count, the sum and the histogram of the values;
+ * per folder the totals of the entries in it (direct) and of all entries below it (recursive).
+ *
+ * Nothing is allocated per path: the extensions are looked up by views in an interned table,
+ * the parent folders in a PathTree (the part shared with the previous path is not looked up again,
+ * so the sorted inventories are the fastest). The recursive totals are summed up through
+ * the folder tree once, by rollUp(), instead of walking the ancestors of each path.
+ *
+ * PathAggregator agg;
+ * agg.add(u"/photos/2021/img.JPG", 2048);
+ * agg.add(u"/photos/notes.txt", 100);
+ * agg.rollUp();
+ * agg.extension(u"jpg").total                       -> 2048
+ * agg.direct(agg.folders().find(u"/photos")).total    -> 100
+ * agg.recursive(agg.folders().find(u"/photos")).total -> 2148
+ *
+ * The partial aggregators of several workers are joined by merge(), see aggregate() (batch.h).
+ * The const functions don't change anything: a finished aggregator can be read by many threads.
+ */
+class PathAggregator
+{
+public:
+    PathAggregator();
+
+    void add(QStringView path, qint64 value);
+
+    // Adds the pairs aggregated by the <other>
+    void merge(const PathAggregator &other);
+
+    // All added pairs
+    AggregateStats total() const;
+
+    /*** Extensions ***/
+    // The number of distinct extensions, the empty one (no suffix) included
+    int extensionCount() const;
+
+    // "tar.gz", lower-case; "" for the names without a suffix
+    QString extensionName(int index) const;
+    const ExtensionStats &extensionStats(int index) const;
+
+    // The stats of the <ext> ("tar.gz" or ".tar.gz", any case), empty if there are none
+    ExtensionStats extension(QStringView ext) const;
+
+    // The bucket of the <value> in the histogram
+    static int histogramBucket(qint64 value);
+
+    /*** Folders ***/
+    // The parent folders of the added paths and their ancestors; the relative paths without one are in none
+    const PathTree &folders() const;
+
+    // The entries right in the <folder>
+    AggregateStats direct(PathTree::Handle folder) const;
+
+    // Sums up the recursive totals through the folder tree, O(folders); aggregate() does it
+    void rollUp();
+
+    // The entries in the <folder> and in its subfolders: O(1) after rollUp(),
+    // summed up for the call (O(folders)) if anything was added since
+    AggregateStats recursive(PathTree::Handle folder) const;
+
+private:
+    int extensionIndex(QStringView lowerExt);
+    std::vector<AggregateStats> sumUp() const;
+
+    AggregateStats m_total;
+
+    PathSet m_extensions;                     // the interned extension names, indexed as the stats
+    std::vector<ExtensionStats> m_extensionStats;
+    QString m_lowerBuffer;                    // reused by lowerCompleteSuffixView()
+
+    PathTree m_folders;
+    std::vector<AggregateStats> m_direct;     // by the folder handle
+    std::vector<AggregateStats> m_recursive;  // by the folder handle, valid if m_rolledUp
+    bool m_rolledUp = true;
+};
+
+} // namespace pathstr
+
+#endif // AGGREGATE_H
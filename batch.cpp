@@ -0,0 +1,812 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "batch.h"
+#include "pathstr.h"
+#include "pathstr_p.h"
+#include "aggregate.h"
+#include "extensionset.h"
+#include "pathbuffer.h"
+#include "pathglob.h"
+#include "rootset.h"
+#include "pathinfo.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace pathstr {
+static const int s_chunkSize = 1024;
+
+static int chunkCount(int size)
+{
+    return (size + s_chunkSize - 1) / s_chunkSize;
+}
+
+/* Calls <func(chunk, begin, end)> for every chunk of [0, size).
+ * The workers take the next free chunk from the shared counter,
+ * so the uneven chunks do not leave the other threads idle.
+ */
+template <typename Func>
+static void forEachChunk(int size, int threads, Func func)
+{
+    const int chunks = chunkCount(size);
+
+    threads = std::min(workerCount(threads), chunks);
+
+    std::atomic<int> next { 0 };
+    auto worker = [&]() {
+        for (int chunk = next++; chunk < chunks; chunk = next++)
+            func(chunk, chunk * s_chunkSize, std::min(size, (chunk + 1) * s_chunkSize));
+    };
+
+    if (threads < 2) {
+        worker();
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int i = 1; i < threads; ++i)
+        pool.emplace_back(worker);
+
+    worker();
+
+    for (std::thread &thread : pool)
+        thread.join();
+}
+
+// A list of <size> null strings, to be filled in place
+static QStringList presized(int size)
+{
+    QStringList list;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    list.resize(size);
+#else
+    list.reserve(size);
+    for (int i = 0; i < size; ++i)
+        list.append(QString());
+#endif
+    return list;
+}
+
+// <func(path)> of every path
+template <typename Func>
+static QStringList transform(const QStringList &paths, int threads, Func func)
+{
+    QStringList result = presized(paths.size());
+    const QStringList::iterator out = result.begin(); // detached here, before the workers start
+
+    forEachChunk(paths.size(), threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            out[i] = func(paths.at(i));
+    });
+
+    return result;
+}
+
+// The paths for which <pred(path)> is true, in the input order
+template <typename Pred>
+static QStringList filter(const QStringList &paths, int threads, Pred pred)
+{
+    // #1 pass: the matches and their number in each chunk
+    std::vector<char> matched(paths.size());
+    std::vector<int> offsets(chunkCount(paths.size()) + 1);
+
+    forEachChunk(paths.size(), threads, [&](int chunk, int begin, int end) {
+        int found = 0;
+        for (int i = begin; i < end; ++i) {
+            matched[i] = pred(paths.at(i));
+            found += matched[i];
+        }
+        offsets[chunk + 1] = found;
+    });
+
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+
+    // #2 pass: each chunk copies its matches from its offset in the result
+    QStringList result = presized(offsets.back());
+    if (result.isEmpty())
+        return result;
+
+    const QStringList::iterator out = result.begin();
+
+    forEachChunk(paths.size(), threads, [&](int chunk, int begin, int end) {
+        int pos = offsets[chunk];
+        for (int i = begin; i < end; ++i) {
+            if (matched[i])
+                out[pos++] = paths.at(i);
+        }
+    });
+
+    return result;
+}
+
+QStringList relativePaths(const QString &rootFolder, const QStringList &paths, int threads)
+{
+    return transform(paths, threads, [&](const QString &path) { return relativePath(rootFolder, path); });
+}
+
+QStringList relativePaths(const RootSet &roots, const QStringList &paths, int threads, QVector<int> *rootIndexes)
+{
+    QStringList result = presized(paths.size());
+    const QStringList::iterator out = result.begin();
+
+    int *indexes = nullptr;
+    if (rootIndexes) {
+        rootIndexes->resize(paths.size());
+        indexes = rootIndexes->data();
+    }
+
+    forEachChunk(paths.size(), threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const QString &path = paths.at(i);
+            QStringView rel;
+            const int index = roots.find(path, &rel);
+
+            if (indexes)
+                indexes[i] = index;
+
+            // the whole path (an empty root) shares the data
+            out[i] = (index != -1 && rel.size() == path.size()) ? path : rel.toString();
+        }
+    });
+
+    return result;
+}
+
+QStringList setSuffixes(const QStringList &paths, const QString &suf, int threads)
+{
+    return transform(paths, threads, [&](const QString &path) { return setSuffix(path, suf); });
+}
+
+QStringList renameFiles(const QStringList &paths, const QString &newName, int threads)
+{
+    return transform(paths, threads, [&](const QString &path) { return renameFile(path, newName); });
+}
+
+QStringList filterByExtension(const QStringList &paths, const ExtensionSet &extensions, int threads)
+{
+    return filter(paths, threads, [&](const QString &path) { return extensions.matches(path); });
+}
+
+QStringList filterByGlob(const QStringList &paths, const PathGlob &glob, int threads)
+{
+    return filter(paths, threads, [&](const QString &path) { return glob.matches(path); });
+}
+
+/*** Columnar batch processing ***/
+/* <func(path, out)> appends the results for each path to the <out> buffer of its chunk.
+ * A result is at most <growth> code units longer than its path.
+ */
+template <typename Func>
+static PathBuffer transform(const PathBuffer &paths, int threads, int growth, Func func)
+{
+    // a single worker writes straight into the result, with no copy of the chunk buffers
+    if (std::min(workerCount(threads), chunkCount(paths.size())) < 2) {
+        PathBuffer result;
+        result.reserve(paths.size(), paths.dataSize() + qint64(growth) * paths.size());
+        for (QStringView path : paths)
+            func(path, result);
+        return result;
+    }
+
+    std::vector<PathBuffer> parts(chunkCount(paths.size()));
+
+    forEachChunk(paths.size(), threads, [&](int chunk, int begin, int end) {
+        const QStringView last = paths.at(end - 1);
+        PathBuffer &out = parts[chunk];
+
+        out.reserve(end - begin, last.utf16() + last.size() - paths.at(begin).utf16() + qint64(growth) * (end - begin));
+        for (int i = begin; i < end; ++i)
+            func(paths.at(i), out);
+    });
+
+    int count = 0;
+    qint64 size = 0;
+    for (const PathBuffer &part : parts) {
+        count += part.size();
+        size += part.dataSize();
+    }
+
+    PathBuffer result;
+    result.reserve(count, size);
+    for (const PathBuffer &part : parts)
+        result.append(part);
+
+    return result;
+}
+
+PathBuffer relativePaths(const QString &rootFolder, const PathBuffer &paths, int threads)
+{
+    return transform(paths, threads, 0, [&](QStringView path, PathBuffer &out) {
+        out.append(core::relativePath(QStringView(rootFolder), path));
+    });
+}
+
+PathBuffer setSuffixes(const PathBuffer &paths, const QString &suf, int threads)
+{
+    // the dot and the new suffix
+    return transform(paths, threads, suf.size() + 1, [&](QStringView path, PathBuffer &out) {
+        const int sufSize = PathInfo(path).suffixSize();
+
+        if (sufSize > 0) {
+            out.append({ path.left(path.size() - sufSize), suf });
+            return;
+        }
+
+        // joinStrings(path, suf, '.')
+        const bool pathEnds = path.endsWith(QLatin1Char('.'));
+        const bool sufStarts = suf.startsWith(QLatin1Char('.'));
+
+        if (pathEnds && sufStarts)
+            out.append({ path.left(path.size() - 1), suf });
+        else if (pathEnds || sufStarts)
+            out.append({ path, suf });
+        else
+            out.append({ path, u".", suf });
+    });
+}
+
+PathBuffer entryNames(const PathBuffer &paths, int threads)
+{
+    return transform(paths, threads, 0, [](QStringView path, PathBuffer &out) {
+        out.append(PathInfo(path).entryName());
+    });
+}
+
+PathBuffer filterByExtension(const PathBuffer &paths, const ExtensionSet &extensions, int threads)
+{
+    return transform(paths, threads, 0, [&](QStringView path, PathBuffer &out) {
+        if (extensions.matches(path))
+            out.append(path);
+    });
+}
+
+// Spawning the threads pays off on the long lists only: a path takes a few ns to compare
+static const int s_minParallelAncestor = 64 * s_chunkSize;
+
+QStringView commonAncestorView(const QStringList &paths, int threads)
+{
+    if (paths.isEmpty())
+        return QStringView();
+
+    if (paths.size() < s_minParallelAncestor)
+        threads = 1;
+
+    // #1 pass: the common ancestor of each chunk; the first null one stops the others
+    std::vector<QStringView> ancestors(chunkCount(paths.size()));
+    std::atomic<bool> none { false };
+
+    forEachChunk(paths.size(), threads, [&](int chunk, int begin, int end) {
+        if (none.load(std::memory_order_relaxed))
+            return;
+
+        QStringView ancestor = core::commonAncestor(QStringView(paths.at(begin)), QStringView(paths.at(begin)));
+
+        for (int i = begin + 1; i < end && !ancestor.isNull(); ++i)
+            ancestor = core::commonAncestor(ancestor, QStringView(paths.at(i)));
+
+        if (ancestor.isNull())
+            none.store(true, std::memory_order_relaxed);
+        ancestors[chunk] = ancestor;
+    });
+
+    if (none.load(std::memory_order_relaxed))
+        return QStringView();
+
+    // #2: merged in order, so the result is a view into the first path
+    QStringView result = ancestors.front();
+    for (size_t i = 1; i < ancestors.size() && !result.isNull(); ++i)
+        result = core::commonAncestor(result, ancestors[i]);
+
+    return result;
+}
+
+QString commonAncestor(const QStringList &paths, int threads)
+{
+    const QStringView ancestor = commonAncestorView(paths, threads);
+
+    // the whole first path shares the data
+    return (!ancestor.isNull() && ancestor.size() == paths.first().size()) ? paths.first() : ancestor.toString();
+}
+
+/*** Sorting ***/
+// Calls <func(part)> for each of the <parts> in its own thread
+template <typename Func>
+static void forEachPart(int parts, Func func)
+{
+    std::vector<std::thread> pool;
+    pool.reserve(parts - 1);
+    for (int part = 1; part < parts; ++part)
+        pool.emplace_back(func, part);
+
+    func(0);
+
+    for (std::thread &thread : pool)
+        thread.join();
+}
+
+static inline bool isDigit(char16_t ch)
+{
+    return ch >= u'0' && ch <= u'9';
+}
+
+static const int s_insertionSize = 16;
+static const int s_samplesPerPart = 64;
+
+// A path being sorted: the keys before the <pos> are the same within its group
+struct SortItem {
+    const char16_t *data;
+    int size;
+    int pos;
+    int index;
+    bool inNumber; // natural order: the size key of the number is taken, the digits are next
+};
+
+/* The sort keys of the paths: the end of a path is 0, '/' is 1, other code units are above.
+ * A key holds the next 3 code units, 21 bits each, the missing ones after the end are 0.
+ * In the natural order a key holds a single unit, and a number starts with a key of its size
+ * (without the leading zeros), so the shorter numbers sort first, then its digits follow.
+ * Either way, the low 21 bits of a key are 0 only if the path ends there.
+ */
+class PathOrder
+{
+public:
+    PathOrder(Qt::CaseSensitivity cs, bool natural)
+        : m_caseFold(cs == Qt::CaseInsensitive), m_natural(natural)
+    {}
+
+    static SortItem item(QStringView path, int index)
+    {
+        return { path.utf16(), static_cast<int>(path.size()), 0, index, false };
+    }
+
+    static bool isEnd(quint64 key)
+    {
+        return (key & 0x1FFFFF) == 0;
+    }
+
+    quint64 key(const SortItem &item) const
+    {
+        if (!m_natural) {
+            const char16_t *data = item.data + item.pos;
+            const int rest = item.size - item.pos;
+
+            quint64 key = (rest > 0) ? unitKey(data[0]) : 0;
+            key = (key << 21) | ((rest > 1) ? unitKey(data[1]) : 0);
+            key = (key << 21) | ((rest > 2) ? unitKey(data[2]) : 0);
+            return key;
+        }
+
+        if (item.pos == item.size)
+            return 0;
+
+        const char16_t ch = item.data[item.pos];
+
+        if (!item.inNumber && isDigit(ch)) {
+            const int start = skipZeros(item, item.pos);
+            int end = start;
+            while (end < item.size && isDigit(item.data[end]))
+                ++end;
+
+            return (quint32(u'0') << 16) | quint32(2 + std::min(end - start, 0xFFFD));
+        }
+
+        return (ch == u'/') ? 1 : (quint32(m_caseFold ? foldCase(ch) : ch) << 16) | 2;
+    }
+
+    // Moves the <item> past its key, which is not the end
+    void advance(SortItem &item) const
+    {
+        if (!m_natural) {
+            item.pos += 3;
+            return;
+        }
+
+        const char16_t ch = item.data[item.pos];
+
+        if (!item.inNumber && isDigit(ch)) {
+            item.pos = skipZeros(item, item.pos);
+            item.inNumber = true;
+            return;
+        }
+
+        ++item.pos;
+        item.inNumber = item.inNumber && isDigit(ch);
+    }
+
+    // Compares the rest of the keys
+    int compare(SortItem item1, SortItem item2) const
+    {
+        for (;;) {
+            const quint64 key1 = key(item1);
+            const quint64 key2 = key(item2);
+
+            if (key1 != key2)
+                return (key1 < key2) ? -1 : 1;
+            if (isEnd(key1))
+                return 0;
+
+            advance(item1);
+            advance(item2);
+        }
+    }
+
+    // The total order: the equal paths by their indexes
+    bool less(const SortItem &item1, const SortItem &item2) const
+    {
+        const int cmp = compare(item1, item2);
+        return (cmp != 0) ? (cmp < 0) : (item1.index < item2.index);
+    }
+
+private:
+    quint32 unitKey(char16_t ch) const
+    {
+        if (ch == u'/')
+            return 1;
+
+        return quint32(m_caseFold ? foldCase(ch) : ch) + 2;
+    }
+
+    static int skipZeros(const SortItem &item, int pos)
+    {
+        while (pos < item.size && item.data[pos] == u'0')
+            ++pos;
+        return pos;
+    }
+
+    bool m_caseFold;
+    bool m_natural;
+};
+
+static bool indexLess(const SortItem &item1, const SortItem &item2)
+{
+    return item1.index < item2.index;
+}
+
+/* Multikey quicksort: the items are split by the keys at their positions into the lower,
+ * equal and greater ones, only the equal ones move on to the next key.
+ * The <keys> is a buffer of the same size: the keys are taken once per position,
+ * the lower and greater ranges are split further by the same keys.
+ */
+static void sortItems(const PathOrder &order, SortItem *items, quint64 *keys, int size)
+{
+    struct Range {
+        int begin;
+        int end;
+        bool hasKeys; // the keys of the items at their positions are taken
+    };
+
+    std::vector<Range> ranges { { 0, size, false } };
+
+    while (!ranges.empty()) {
+        const Range range = ranges.back();
+        const int begin = range.begin;
+        const int end = range.end;
+        ranges.pop_back();
+
+        if (end - begin < s_insertionSize) {
+            for (int i = begin + 1; i < end; ++i) {
+                const SortItem item = items[i];
+                int j = i;
+                for (; j > begin; --j) {
+                    const int cmp = order.compare(item, items[j - 1]);
+                    if (cmp > 0 || (cmp == 0 && item.index > items[j - 1].index))
+                        break;
+                    items[j] = items[j - 1];
+                }
+                items[j] = item;
+            }
+            continue;
+        }
+
+        if (!range.hasKeys) {
+            for (int i = begin; i < end; ++i)
+                keys[i] = order.key(items[i]);
+        }
+
+        // the median of three
+        quint64 a = keys[begin], b = keys[begin + (end - begin) / 2], c = keys[end - 1];
+        if (a > b)
+            std::swap(a, b);
+        const quint64 pivot = (c <= a) ? a : std::min(b, c);
+
+        int lower = begin;
+        int greater = end;
+        for (int i = begin; i < greater;) {
+            if (keys[i] < pivot) {
+                std::swap(items[i], items[lower]);
+                std::swap(keys[i++], keys[lower++]);
+            } else if (keys[i] > pivot) {
+                --greater;
+                std::swap(items[i], items[greater]);
+                std::swap(keys[i], keys[greater]);
+            } else {
+                ++i;
+            }
+        }
+
+        ranges.push_back({ begin, lower, true });
+        ranges.push_back({ greater, end, true });
+
+        if (PathOrder::isEnd(pivot)) {
+            // the same paths: the input order
+            std::sort(items + lower, items + greater, indexLess);
+        } else {
+            for (int i = lower; i < greater; ++i)
+                order.advance(items[i]);
+            ranges.push_back({ lower, greater, false });
+        }
+    }
+}
+
+QVector<int> sortedPathIndexes(const QStringList &paths, Qt::CaseSensitivity cs, bool natural, int threads)
+{
+    const int size = paths.size();
+
+    const PathOrder order(cs, natural);
+    std::vector<SortItem> items(size);
+    std::vector<quint64> keys(size);
+
+    // the buckets between the sampled paths, a few per thread for the uneven ones
+    const int parts = std::max(1, std::min(workerCount(threads), size / s_chunkSize));
+    const int buckets = (parts > 1) ? parts * 4 : 1;
+    std::vector<int> bucketBounds { 0, size };
+
+    if (buckets == 1) {
+        for (int i = 0; i < size; ++i)
+            items[i] = PathOrder::item(paths.at(i), i);
+    } else {
+        std::vector<SortItem> sample(buckets * s_samplesPerPart);
+        for (int i = 0; i < int(sample.size()); ++i) {
+            const int index = static_cast<qint64>(size) * i / sample.size();
+            sample[i] = PathOrder::item(paths.at(index), index);
+        }
+
+        auto less = [&](const SortItem &item1, const SortItem &item2) { return order.less(item1, item2); };
+        std::sort(sample.begin(), sample.end(), less);
+
+        std::vector<SortItem> splitters(buckets - 1);
+        for (int i = 1; i < buckets; ++i)
+            splitters[i - 1] = sample[i * s_samplesPerPart];
+
+        // #1 pass: the bucket of each path and the bucket sizes in each part
+        std::vector<int> bucketOf(size);
+        std::vector<int> counts(parts * buckets);
+        auto bound = [&](int part) { return static_cast<int>(static_cast<qint64>(size) * part / parts); };
+
+        forEachPart(parts, [&](int part) {
+            int *partCounts = counts.data() + part * buckets;
+            for (int i = bound(part); i < bound(part + 1); ++i) {
+                const SortItem item = PathOrder::item(paths.at(i), i);
+                bucketOf[i] = std::upper_bound(splitters.begin(), splitters.end(), item, less) - splitters.begin();
+                ++partCounts[bucketOf[i]];
+            }
+        });
+
+        // #2 pass: each part writes its paths after the ones of the previous parts, keeping the order
+        bucketBounds.assign(buckets + 1, 0);
+        std::vector<int> offsets(parts * buckets);
+        int offset = 0;
+        for (int bucket = 0; bucket < buckets; ++bucket) {
+            bucketBounds[bucket] = offset;
+            for (int part = 0; part < parts; ++part) {
+                offsets[part * buckets + bucket] = offset;
+                offset += counts[part * buckets + bucket];
+            }
+        }
+        bucketBounds[buckets] = size;
+
+        forEachPart(parts, [&](int part) {
+            int *partOffsets = offsets.data() + part * buckets;
+            for (int i = bound(part); i < bound(part + 1); ++i)
+                items[partOffsets[bucketOf[i]]++] = PathOrder::item(paths.at(i), i);
+        });
+    }
+
+    std::atomic<int> next { 0 };
+    auto sortBuckets = [&](int) {
+        for (int bucket = next++; bucket < buckets; bucket = next++) {
+            const int begin = bucketBounds[bucket];
+            sortItems(order, items.data() + begin, keys.data() + begin, bucketBounds[bucket + 1] - begin);
+        }
+    };
+    forEachPart(parts, sortBuckets);
+
+    QVector<int> result(size);
+    for (int i = 0; i < size; ++i)
+        result[i] = items[i].index;
+
+    return result;
+}
+
+void sortPaths(QStringList &paths, Qt::CaseSensitivity cs, bool natural, int threads)
+{
+    const QVector<int> order = sortedPathIndexes(paths, cs, natural, threads);
+
+    // the strings are moved along the cycles of the permutation
+    std::vector<char> placed(paths.size());
+    const QStringList::iterator out = paths.begin(); // detached here
+
+    for (int start = 0; start < paths.size(); ++start) {
+        if (placed[start])
+            continue;
+
+        QString first = std::move(out[start]);
+        int pos = start;
+
+        for (;;) {
+            placed[pos] = true;
+            const int from = order.at(pos);
+            if (from == start) {
+                out[pos] = std::move(first);
+                break;
+            }
+            out[pos] = std::move(out[from]);
+            pos = from;
+        }
+    }
+}
+
+int comparePaths(QStringView path1, QStringView path2, Qt::CaseSensitivity cs, bool natural)
+{
+    return PathOrder(cs, natural).compare(PathOrder::item(path1, 0), PathOrder::item(path2, 1));
+}
+
+
+/*** Snapshot diff ***/
+static bool pathLess(const QString &path1, const QString &path2)
+{
+    return comparePaths(path1, path2) < 0;
+}
+
+static void append(QStringList &list, const QStringList &other)
+{
+    for (const QString &str : other)
+        list.append(str);
+}
+
+SnapshotDiff diffSnapshots(const QStringList &previous, const QStringList &current, int threads)
+{
+    // the shared strings are sorted, not copied
+    QStringList prev = previous;
+    QStringList cur = current;
+    sortPaths(prev, Qt::CaseSensitive, false, threads);
+    sortPaths(cur, Qt::CaseSensitive, false, threads);
+
+    return diffSortedSnapshots(prev, cur, threads);
+}
+
+SnapshotDiff diffSortedSnapshots(const QStringList &previous, const QStringList &current, int threads)
+{
+    // the parts are split at the same paths in both snapshots
+    const QStringList &splitList = previous.size() >= current.size() ? previous : current;
+    const int parts = std::max(1, std::min(workerCount(threads), int(splitList.size()) / s_chunkSize));
+
+    std::vector<int> prevBounds(parts + 1, previous.size());
+    std::vector<int> curBounds(parts + 1, current.size());
+    prevBounds[0] = curBounds[0] = 0;
+
+    for (int part = 1; part < parts; ++part) {
+        const QString &split = splitList.at(static_cast<qint64>(splitList.size()) * part / parts);
+        prevBounds[part] = std::lower_bound(previous.begin(), previous.end(), split, pathLess) - previous.begin();
+        curBounds[part] = std::lower_bound(current.begin(), current.end(), split, pathLess) - current.begin();
+    }
+
+    std::vector<SnapshotDiff> results(parts);
+
+    forEachPart(parts, [&](int part) {
+        int prevInd = prevBounds[part];
+        int curInd = curBounds[part];
+        const int prevEnd = prevBounds[part + 1];
+        const int curEnd = curBounds[part + 1];
+
+        auto nextPrevious = [&](QStringView &path) {
+            if (prevInd == prevEnd)
+                return false;
+            path = previous.at(prevInd++);
+            return true;
+        };
+
+        auto nextCurrent = [&](QStringView &path) {
+            if (curInd == curEnd)
+                return false;
+            path = current.at(curInd++);
+            return true;
+        };
+
+        // the whole paths are shared: taken from the lists by their positions in the part
+        SnapshotDiff &result = results[part];
+
+        auto sink = [&](core::DiffKind kind, QStringView path, int pos) {
+            switch (kind) {
+            case core::DiffKind::Added:
+                result.added.append(current.at(curBounds[part] + pos));
+                break;
+            case core::DiffKind::Removed:
+                result.removed.append(previous.at(prevBounds[part] + pos));
+                break;
+            case core::DiffKind::RemovedFolder:
+                result.removedFolders.append(path.toString());
+                break;
+            }
+        };
+
+        const int before = curBounds[part] - 1;
+        const int after = curEnd;
+        core::diffSorted<QStringView>(nextPrevious, nextCurrent, sink,
+                                      before >= 0 ? QStringView(current.at(before)) : QStringView(), before >= 0,
+                                      after < current.size() ? QStringView(current.at(after)) : QStringView(),
+                                      after < current.size());
+    });
+
+    SnapshotDiff diff = results[0];
+
+    for (int part = 1; part < parts; ++part) {
+        SnapshotDiff &result = results[part];
+
+        // a folder split by the parts: the same folder is found in both
+        if (!result.removedFolders.isEmpty()) {
+            const QString &first = result.removedFolders.first();
+            if (!diff.removedFolders.isEmpty() && diff.removedFolders.last() == first)
+                result.removedFolders.removeFirst();
+            if (!diff.removed.isEmpty() && diff.removed.last() == first)
+                diff.removed.removeLast();
+        }
+
+        append(diff.added, result.added);
+        append(diff.removed, result.removed);
+        append(diff.removedFolders, result.removedFolders);
+    }
+
+    return diff;
+}
+
+/*** Aggregation ***/
+// Each worker aggregates a contiguous part: the folders of a sorted list stay together
+template <typename Paths>
+static PathAggregator aggregateParts(const Paths &paths, const QVector<qint64> &values, int threads)
+{
+    Q_ASSERT(static_cast<int>(paths.size()) == values.size());
+
+    const int size = std::min(static_cast<int>(paths.size()), static_cast<int>(values.size()));
+    const int parts = std::max(1, std::min(workerCount(threads), chunkCount(size)));
+    auto bound = [&](int part) { return static_cast<int>(static_cast<qint64>(size) * part / parts); };
+
+    std::vector<PathAggregator> results(parts);
+
+    forEachPart(parts, [&](int part) {
+        PathAggregator &result = results[part];
+        for (int i = bound(part); i < bound(part + 1); ++i)
+            result.add(paths.at(i), values.at(i));
+    });
+
+    for (int part = 1; part < parts; ++part)
+        results.front().merge(results[part]);
+
+    results.front().rollUp();
+    return std::move(results.front());
+}
+
+PathAggregator aggregate(const QStringList &paths, const QVector<qint64> &values, int threads)
+{
+    return aggregateParts(paths, values, threads);
+}
+
+PathAggregator aggregate(const PathBuffer &paths, const QVector<qint64> &values, int threads)
+{
+    return aggregateParts(paths, values, threads);
+}
+
+} // namespace pathstr
@@ -0,0 +1,154 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHSTR_BATCH_H
+#define PATHSTR_BATCH_H
+
+#include <QStringList>
+#include <QVector>
+
+namespace pathstr {
+class ExtensionSet;
+class PathAggregator;
+class PathBuffer;
+class PathGlob;
+class RootSet;
+
+/*** Batch processing ***/
+/* The list is split into chunks, which are taken by <threads> worker threads as they finish
+ * the previous ones (0 -> all hardware threads). The results are written in place
+ * and keep the order of the input; short lists are processed in the calling thread.
+ */
+
+// relativePath(rootFolder, path) of every path
+QStringList relativePaths(const QString &rootFolder, const QStringList &paths, int threads = 0);
+
+/* relativePath() of every path against the deepest of the <roots> containing it, a null string
+ * if there is none. The root indexes are written to the <rootIndexes> if it's not null.
+ */
+QStringList relativePaths(const RootSet &roots, const QStringList &paths, int threads = 0,
+                          QVector<int> *rootIndexes = nullptr);
+
+// setSuffix(path, suf) of every path
+QStringList setSuffixes(const QStringList &paths, const QString &suf, int threads = 0);
+
+// renameFile(path, newName) of every path
+QStringList renameFiles(const QStringList &paths, const QString &newName, int threads = 0);
+
+// The paths matching the <extensions>
+QStringList filterByExtension(const QStringList &paths, const ExtensionSet &extensions, int threads = 0);
+
+// The paths matching the <glob>
+QStringList filterByGlob(const QStringList &paths, const PathGlob &glob, int threads = 0);
+
+/* The deepest folder containing all the <paths>, e.g. the root folder for relativePaths().
+ * The paths are compared by a SIMD first-mismatch scan and cut back to the last separator.
+ * A path is its own ancestor, the trailing separator is dropped as by parentFolder(),
+ * the root is kept as is, a run of separators is one. A null string if the roots differ or nothing is shared.
+ * The long lists are reduced by the <threads> in chunks, then the chunk results are merged.
+ *
+ * {"/home/user/photos/img.jpg", "/home/user/docs/"} -> "/home/user"
+ * {"/home/user/docs/", "/home/user/docs/file.txt"}  -> "/home/user/docs"
+ * {"C:/folder/file", "c:\\folder2"}                  -> "C:/"
+ * {"/home/file", "C:/file"}                         -> null
+ */
+QString commonAncestor(const QStringList &paths, int threads = 0);
+
+// The same as commonAncestor(), a view into the first path
+QStringView commonAncestorView(const QStringList &paths, int threads = 0);
+
+
+/*** Columnar batch processing ***/
+/* The same over a PathBuffer (pathbuffer.h): the chunks are read from the blob in place, each one
+ * writes its results into a buffer of its own and the buffers are joined in order.
+ * Nothing is allocated per path.
+ */
+
+// relativePath(rootFolder, path) of every path, an empty one if not in the <rootFolder>
+PathBuffer relativePaths(const QString &rootFolder, const PathBuffer &paths, int threads = 0);
+
+// setSuffix(path, suf) of every path
+PathBuffer setSuffixes(const PathBuffer &paths, const QString &suf, int threads = 0);
+
+// entryNameView(path) of every path, an empty one for the roots
+PathBuffer entryNames(const PathBuffer &paths, int threads = 0);
+
+// The paths matching the <extensions>
+PathBuffer filterByExtension(const PathBuffer &paths, const ExtensionSet &extensions, int threads = 0);
+
+
+/*** Sorting ***/
+/* The order of sortPaths(): as comparePaths(), '/' sorts before any other character.
+ * Case-insensitive: the characters are compared case-folded.
+ * Natural: the numbers in the names are compared by their values, "file2" < "file10";
+ * the leading zeros are ignored, so "01" and "1" are equal.
+ */
+int comparePaths(QStringView path1, QStringView path2, Qt::CaseSensitivity cs, bool natural = false);
+
+/* Sorts the <paths> in the comparePaths() order, the equal ones keep their order.
+ * A multikey quicksort over the path indexes: the code units of a group of paths are compared
+ * once at each position, the common prefixes are not compared again. The list is split
+ * into parts by the sampled paths, the parts are sorted by the <threads>, and the strings
+ * are moved once into their places at the end.
+ *
+ * { "/b", "/a/z", "/B/y" }:
+ * sortPaths(list)                      -> "/B/y", "/a/z", "/b"
+ * sortPaths(list, Qt::CaseInsensitive) -> "/a/z", "/b", "/B/y"
+ * { "/f/10.txt", "/f/2.txt" }:
+ * sortPaths(list, Qt::CaseSensitive, true) -> "/f/2.txt", "/f/10.txt"
+ */
+void sortPaths(QStringList &paths, Qt::CaseSensitivity cs = Qt::CaseSensitive, bool natural = false,
+               int threads = 0);
+
+// The indexes of the <paths> in the sortPaths() order, the list itself is not changed
+QVector<int> sortedPathIndexes(const QStringList &paths, Qt::CaseSensitivity cs = Qt::CaseSensitive,
+                               bool natural = false, int threads = 0);
+
+
+/*** Snapshot diff ***/
+struct SnapshotDiff {
+    QStringList added;
+    QStringList removed;        // the removed paths outside the removed folders
+    QStringList removedFolders; // the topmost folders with nothing left in them
+};
+
+/* The difference between two snapshots of a file system, the lists are in the comparePaths() order.
+ * A folder which has no paths left in the <current> snapshot is reported as a whole (in the
+ * removedFolders), its removed contents are not listed. The snapshots are sorted first,
+ * then merged in parts by all <threads>: only the pointers of the shared strings are copied.
+ *
+ * previous: { "/a/file", "/b/x/1", "/b/x/2", "/b/y" }
+ * current:  { "/a/file", "/a/new", "/b/y" }
+ * -> added: { "/a/new" }, removed: {}, removedFolders: { "/b/x" }
+ */
+SnapshotDiff diffSnapshots(const QStringList &previous, const QStringList &current, int threads = 0);
+
+// The same for the snapshots already sorted in the comparePaths() order
+SnapshotDiff diffSortedSnapshots(const QStringList &previous, const QStringList &current, int threads = 0);
+
+
+/*** Aggregation ***/
+/* The PathAggregator (aggregate.h) of the <paths> with their <values>, one value per path:
+ * the sizes must be equal (asserted in the debug builds; otherwise the pairs beyond
+ * the shorter one are ignored). Each of the <threads> workers aggregates a contiguous part
+ * of the list into its own one, the partial results are merged and rolled up
+ * (PathAggregator::rollUp()) at the end.
+ *
+ * const PathAggregator agg = aggregate(files, sizes);
+ * agg.recursive(agg.folders().find(u"/home")).total -> the size of all files under "/home"
+ */
+PathAggregator aggregate(const QStringList &paths, const QVector<qint64> &values, int threads = 0);
+PathAggregator aggregate(const PathBuffer &paths, const QVector<qint64> &values, int threads = 0);
+
+} // namespace pathstr
+
+#endif // PATHSTR_BATCH_H
@@ -0,0 +1,1130 @@
+/*
+ * Benchmarks of the pathstr functions against the QFileInfo/QDir equivalents.
+ *
+ * Usage: bench_pathstr [--csv | --json] [--min-time <ms>] [--filter <text>] [-o <file>] [--profile <file>]
+ *                      [--walk-files <n>]
+ *
+ * Every function is run over the path corpora (short and deep POSIX paths, Windows paths,
+ * multi-dot file names). Results are printed (or written to <file>) as CSV by default:
+ * function,corpus,impl,ns_per_op,allocs_per_op
+ *
+ * Allocations are counted by intercepting malloc (glibc only), so both QString data
+ * and operator new allocations are taken into account. Elsewhere allocs_per_op is -1.
+ *
+ * The directory walk is measured on a generated tree of --walk-files files (100000 by default),
+ * an allocs_per_op of it is per entry.
+ *
+ * Built with PATHSTR_PROFILE, the "profile." rows give the cost of the counting (the calls
+ * with it paused and running), --profile writes the counters of the whole run as JSON.
+ */
+
+#include "pathstr.h"
+#include "extensionset.h"
+#include "pathinfo.h"
+#include "simd.h"
+#include "pathbuilder.h"
+#include "pathbuffer.h"
+#include "aggregate.h"
+#include "batch.h"
+#include "pathcore.h"
+#include "pathlist.h"
+#include "pathtree.h"
+#include "pathglob.h"
+#include "rootset.h"
+#include "pathkey.h"
+#include "profile.h"
+#include "walk.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*** Allocation counter ***/
+#if defined(__GLIBC__)
+#define BENCH_COUNT_ALLOCS 1
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+}
+
+static std::atomic<quint64> s_allocs { 0 };
+
+extern "C" {
+void *malloc(size_t size)
+{
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size)
+{
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+} // extern "C"
+
+static quint64 allocCount()
+{
+    return s_allocs.load(std::memory_order_relaxed);
+}
+#else
+#define BENCH_COUNT_ALLOCS 0
+
+static quint64 allocCount()
+{
+    return 0;
+}
+#endif
+
+namespace {
+/*** Corpora ***/
+struct Corpus {
+    const char *name;
+    QString root;       // common root folder of all paths
+    QStringList paths;
+    std::vector<std::string> utf8; // the same paths
+};
+
+const char *const s_folders[] = {
+    "home", "user", "projects", "src", "build", "node_modules", "lib", "include",
+    "docs", "assets", "Release", "x86_64", "android", "tests", "photos 2021", "very_long_folder_name_here"
+};
+
+const char *const s_names[] = {
+    "main", "README", "index", "archive", "photo_0042", "CMakeLists", "libfoo", "report"
+};
+
+const char *const s_suffixes[] = {
+    "cpp", "h", "txt", "tar.gz", "JPG", "json", "md", "o"
+};
+
+const char *const s_multiDotNames[] = {
+    "report.final.v2.pdf", "libfoo.so.1.2.3", "archive.name.with.dots.tar.gz",
+    "photo.2021.08.15.jpeg", ".hidden.config.json", "data.backup.tar.xz"
+};
+
+// deterministic LCG, the corpora must be the same from run to run
+class Random
+{
+public:
+    int next(int bound)
+    {
+        m_state = m_state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((m_state >> 33) % static_cast<quint64>(bound));
+    }
+
+private:
+    quint64 m_state = 42;
+};
+
+template <typename T, size_t N>
+constexpr int arraySize(const T (&)[N])
+{
+    return static_cast<int>(N);
+}
+
+QStringList makePaths(Random &rnd, const QString &root, QChar sep,
+                      int minDepth, int maxDepth, bool multiDot, int count = 10000)
+{
+    QStringList paths;
+    paths.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        QString path = root;
+        const int depth = minDepth + rnd.next(maxDepth - minDepth + 1);
+
+        for (int d = 0; d < depth; ++d) {
+            path += QString::fromLatin1(s_folders[rnd.next(arraySize(s_folders))]);
+            path += sep;
+        }
+
+        if (multiDot) {
+            path += QString::fromLatin1(s_multiDotNames[rnd.next(arraySize(s_multiDotNames))]);
+        } else {
+            path += QString::fromLatin1(s_names[rnd.next(arraySize(s_names))]);
+            path += pathstr::s_dot;
+            path += QString::fromLatin1(s_suffixes[rnd.next(arraySize(s_suffixes))]);
+        }
+
+        // some folder paths with a trailing separator
+        if (rnd.next(8) == 0)
+            path += sep;
+
+        paths.append(path);
+    }
+
+    return paths;
+}
+
+// A directory walk: the files of each folder together, the folders share their parents
+void makeTree(Random &rnd, const QString &folder, int depth, QStringList &paths, int count = 10000)
+{
+    const int files = 5 + rnd.next(25);
+    for (int i = 0; i < files && paths.size() < count; ++i) {
+        paths.append(folder + QString::fromLatin1(s_names[rnd.next(arraySize(s_names))]) + QString::number(i)
+                     + pathstr::s_dot + QString::fromLatin1(s_suffixes[rnd.next(arraySize(s_suffixes))]));
+    }
+
+    if (depth == 0)
+        return;
+
+    const int folders = 2 + rnd.next(4);
+    for (int i = 0; i < folders && paths.size() < count; ++i) {
+        makeTree(rnd, folder + QString::fromLatin1(s_folders[rnd.next(arraySize(s_folders))]) + QString::number(i)
+                          + pathstr::s_sep, depth - 1, paths, count);
+    }
+}
+
+std::vector<Corpus> makeCorpora()
+{
+    Random rnd;
+    std::vector<Corpus> corpora;
+
+    corpora.push_back({ "posix_short", "/home/user", {} });
+    corpora.back().paths = makePaths(rnd, "/home/user/", pathstr::s_sep, 0, 2, false);
+
+    corpora.push_back({ "posix_deep", "/home/user/projects", {} });
+    corpora.back().paths = makePaths(rnd, "/home/user/projects/", pathstr::s_sep, 10, 20, false);
+
+    corpora.push_back({ "windows", "C:\\Users\\user", {} });
+    corpora.back().paths = makePaths(rnd, "C:\\Users\\user\\", u'\\', 2, 8, false);
+
+    corpora.push_back({ "windows_fwd", "D:/data", {} });
+    corpora.back().paths = makePaths(rnd, "D:/data/", pathstr::s_sep, 2, 8, false);
+
+    corpora.push_back({ "multi_dot", "/srv/files", {} });
+    corpora.back().paths = makePaths(rnd, "/srv/files/", pathstr::s_sep, 1, 6, true);
+
+    corpora.push_back({ "posix_tree", "/home/user", {} });
+    makeTree(rnd, "/home/user/", 8, corpora.back().paths);
+
+    for (Corpus &corpus : corpora) {
+        for (const QString &path : corpus.paths)
+            corpus.utf8.push_back(path.toStdString());
+    }
+
+    return corpora;
+}
+
+/*** Results consumer, keeps the compiler from discarding the calls ***/
+volatile qint64 s_sink = 0;
+
+inline void consume(const QString &str) { s_sink = s_sink + str.size(); }
+inline void consume(QStringView str) { s_sink = s_sink + str.size(); }
+inline void consume(std::string_view str) { s_sink = s_sink + str.size(); }
+inline void consume(bool value) { s_sink = s_sink + value; }
+inline void consume(qint64 value) { s_sink = s_sink + value; }
+inline void consume(int value) { s_sink = s_sink + value; }
+
+/*** Runner ***/
+struct Result {
+    QString function;
+    QString corpus;
+    QString impl;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+class Bench
+{
+public:
+    qint64 minTimeNs = 100 * 1000000LL;
+    QString filter;
+    std::vector<Result> results;
+
+    // runs <func(path)> over the corpus until the minimum time is reached
+    template <typename Func>
+    void run(const char *function, const char *impl, const Corpus &corpus, Func func)
+    {
+        measure(function, impl, corpus, corpus.paths, func);
+    }
+
+    // the same over the UTF-8 copy of the corpus
+    template <typename Func>
+    void runUtf8(const char *function, const char *impl, const Corpus &corpus, Func func)
+    {
+        measure(function, impl, corpus, corpus.utf8, func);
+    }
+
+    template <typename Paths, typename Func>
+    void measure(const char *function, const char *impl, const Corpus &corpus, const Paths &paths, Func func)
+    {
+        if (!filter.isEmpty() && !QString::fromLatin1(function).contains(filter))
+            return;
+
+        // warm up
+        for (const auto &path : paths)
+            consume(func(path));
+
+        qint64 ops = 0;
+        QElapsedTimer timer;
+        const quint64 allocsBefore = allocCount();
+        timer.start();
+
+        do {
+            for (const auto &path : paths)
+                consume(func(path));
+            ops += paths.size();
+        } while (timer.nsecsElapsed() < minTimeNs);
+
+        const qint64 elapsed = timer.nsecsElapsed();
+        const quint64 allocs = allocCount() - allocsBefore;
+
+        const double allocsPerOp = BENCH_COUNT_ALLOCS ? static_cast<double>(allocs) / ops : -1.0;
+        results.push_back({ QString::fromLatin1(function), QString::fromLatin1(corpus.name),
+                            QString::fromLatin1(impl), static_cast<double>(elapsed) / ops, allocsPerOp });
+        std::fprintf(stderr, "%-24s %-12s %-14s %10.1f ns/op %8.2f allocs/op\n",
+                     function, corpus.name, impl, results.back().nsPerOp, allocsPerOp);
+    }
+
+    // runs <func(paths)> over the whole list until the minimum time is reached
+    template <typename Func>
+    void runBatch(const char *function, const char *impl, const Corpus &corpus, Func func)
+    {
+        measureCalls(function, impl, corpus, corpus.paths.size(), [&]() { return func(corpus.paths).size(); });
+    }
+
+    // runs <func(list)> over the mapped list of <lines> paths
+    template <typename Func>
+    void runStream(const char *function, const char *impl, const Corpus &corpus,
+                   const pathstr::core::MappedPathList &list, qint64 lines, Func func)
+    {
+        measureCalls(function, impl, corpus, lines, [&]() { return func(list); });
+    }
+
+    // <func()> processes <opsPerCall> paths at once
+    template <typename Func>
+    void measureCalls(const char *function, const char *impl, const Corpus &corpus, qint64 opsPerCall, Func func)
+    {
+        if (!filter.isEmpty() && !QString::fromLatin1(function).contains(filter))
+            return;
+
+        consume(qint64(func())); // warm up
+
+        qint64 ops = 0;
+        QElapsedTimer timer;
+        const quint64 allocsBefore = allocCount();
+        timer.start();
+
+        do {
+            consume(qint64(func()));
+            ops += opsPerCall;
+        } while (timer.nsecsElapsed() < minTimeNs);
+
+        const qint64 elapsed = timer.nsecsElapsed();
+        const quint64 allocs = allocCount() - allocsBefore;
+
+        const double allocsPerOp = BENCH_COUNT_ALLOCS ? static_cast<double>(allocs) / ops : -1.0;
+        results.push_back({ QString::fromLatin1(function), QString::fromLatin1(corpus.name),
+                            QString::fromLatin1(impl), static_cast<double>(elapsed) / ops, allocsPerOp });
+        std::fprintf(stderr, "%-24s %-12s %-14s %10.1f ns/op %8.2f allocs/op\n",
+                     function, corpus.name, impl, results.back().nsPerOp, allocsPerOp);
+    }
+};
+
+/*** Cases ***/
+void runAll(Bench &b, const Corpus &c)
+{
+    using namespace pathstr;
+    const QString add = QStringLiteral(u"child/file.txt");
+    const QStringList extList = { "jpg", "png", "txt", "json", "tar.gz", "cpp", "h", "md" };
+    const ExtensionSet extSet(extList);
+    QStringList extList100 = extList;
+    for (int i = extList100.size(); i < 100; ++i)
+        extList100.append(QStringLiteral(u"ext") + QString::number(i));
+    const ExtensionSet extSet100(extList100);
+    const QDir rootDir(c.root);
+    const std::string rootUtf8 = c.root.toStdString();
+    PathBuilder builder;
+    PathArena arena;
+    QString pathBuffer;
+    pathBuffer.reserve(1024); // kept by resize(0)
+
+    b.run("joinPath", "pathstr", c, [&](const QString &p) { return joinPath(p, add); });
+    b.run("joinPath(chain)", "pathstr", c, [](const QString &p) {
+        return composeFilePath(joinPath(joinPath(p, QStringLiteral(u"a")), QStringLiteral(u"b")),
+                               QStringLiteral(u"c"), QStringLiteral(u"txt"));
+    });
+    b.run("joinPath(chain)", "pathstr_builder", c, [&](const QString &p) {
+        builder.reset(p);
+        return builder.push(u"a").push(u"b").pushFile(u"c", u"txt").path();
+    });
+    b.run("joinPath(chain)", "qt", c, [](const QString &p) {
+        return QDir(QDir(p).filePath(QStringLiteral(u"a"))).filePath(QStringLiteral(u"b/c.txt"));
+    });
+    b.run("PathArena::store", "pathstr", c, [&](const QString &p) {
+        if (arena.size() > (1 << 24))
+            arena.clear();
+        return arena.store(p);
+    });
+    b.run("joinPath", "qt", c, [&](const QString &p) { return QDir(p).filePath(add); });
+    // the in-place API over a reused buffer: no allocation once its capacity is enough
+    b.run("joinPath", "pathstr_into", c, [&](const QString &p) {
+        pathBuffer.resize(0);
+        pathBuffer.append(p);
+        joinPathInto(pathBuffer, add);
+        return qint64(pathBuffer.size());
+    });
+
+    // a rewrite pipeline: each step builds a new string, reuses the data of the previous one, or the buffer
+    b.run("rewrite", "pathstr_copy", c, [](const QString &p) {
+        const QString chopped = chopSep(p);
+        const QString renamed = renameFile(chopped, QStringLiteral(u"new_name"));
+        return setSuffix(renamed, QStringLiteral(u"bak"));
+    });
+    b.run("rewrite", "pathstr_rvalue", c, [](const QString &p) {
+        return setSuffix(renameFile(chopSep(QString(p)), QStringLiteral(u"new_name")), QStringLiteral(u"bak"));
+    });
+    b.run("rewrite", "pathstr_inplace", c, [&](const QString &p) {
+        pathBuffer.resize(0);
+        pathBuffer.append(p);
+        chopSepInPlace(pathBuffer);
+        renameFileInPlace(pathBuffer, u"new_name");
+        setSuffixInPlace(pathBuffer, u"bak");
+        return qint64(pathBuffer.size());
+    });
+    b.run("joinStrings", "pathstr", c, [&](const QString &p) { return joinStrings(p, add, s_sep); });
+
+    b.run("entryName", "pathstr", c, [](const QString &p) { return entryName(p); });
+    b.run("entryName", "pathstr_view", c, [](const QString &p) { return entryNameView(p); });
+    b.runUtf8("entryName", "pathstr_utf8", c, [](std::string_view p) { return core::entryName(p); });
+    b.run("entryName", "qt", c, [](const QString &p) { return QFileInfo(p).fileName(); });
+
+    b.run("baseName", "pathstr", c, [](const QString &p) { return baseName(p); });
+    b.run("baseName", "pathstr_view", c, [](const QString &p) { return baseNameView(p); });
+    b.run("baseName", "qt", c, [](const QString &p) { return QFileInfo(p).completeBaseName(); });
+
+    b.run("parentFolder", "pathstr", c, [](const QString &p) { return parentFolder(p); });
+    b.run("parentFolder", "pathstr_view", c, [](const QString &p) { return parentFolderView(p); });
+    b.runUtf8("parentFolder", "pathstr_utf8", c, [](std::string_view p) { return core::parentFolder(p); });
+    b.run("parentFolder", "qt", c, [](const QString &p) { return QFileInfo(p).path(); });
+
+    // the compile-time policies: the default mixed rules, POSIX only, '\\' splitting as '/'
+    b.run("parentFolder", "pathstr_posix", c, [](const QString &p) { return core::parentFolder<core::PosixPolicy>(QStringView(p)); });
+    b.run("parentFolder", "pathstr_windows", c, [](const QString &p) { return core::parentFolder<core::WindowsPolicy>(QStringView(p)); });
+    b.runUtf8("parentFolder", "pathstr_utf8_posix", c, [](std::string_view p) { return core::parentFolder<core::PosixPolicy>(p); });
+    b.run("root", "pathstr_view_posix", c, [](const QString &p) { return core::root<core::PosixPolicy>(QStringView(p)); });
+    b.run("isAbsolute", "pathstr_view", c, [](const QString &p) { return core::isAbsolute(QStringView(p)); });
+    b.run("isAbsolute", "pathstr_view_posix", c, [](const QString &p) { return core::isAbsolute<core::PosixPolicy>(QStringView(p)); });
+    b.run("PathComponents", "pathstr", c, [](const QString &p) { return qint64(PathComponents(p).count()); });
+    b.run("PathComponents", "pathstr_posix", c, [](const QString &p) {
+        return qint64(core::BasicPathComponents<QStringView, core::PosixPolicy>(p).count());
+    });
+
+    b.run("relativePath", "pathstr", c, [&](const QString &p) { return relativePath(c.root, p); });
+    b.run("relativePath", "pathstr_view", c, [&](const QString &p) { return relativePathView(c.root, p); });
+    b.runUtf8("relativePath", "pathstr_utf8", c, [&](std::string_view p) { return core::relativePath(std::string_view(rootUtf8), p); });
+    b.run("relativePath", "qt", c, [&](const QString &p) { return rootDir.relativeFilePath(p); });
+
+    b.run("renameFile", "pathstr", c, [](const QString &p) { return renameFile(p, QStringLiteral(u"new_name")); });
+    b.run("PathInfo", "pathstr", c, [](const QString &p) {
+        const PathInfo info(p);
+        return qint64(info.parentFolder().size() + info.baseName().size() + info.completeSuffix().size());
+    });
+    // the ancestors of a path, from the deepest one: the lookups of ACL checks and size rollups
+    b.run("ancestors", "pathstr", c, [](const QString &p) {
+        const PathComponents comps(p);
+        qint64 sum = 0;
+        for (auto it = comps.rbegin(); it != comps.rend(); ++it)
+            sum += it.path().size();
+        return sum;
+    });
+    b.run("ancestors", "pathstr_parent", c, [](const QString &p) {
+        qint64 sum = 0;
+        for (QString path = chopSep(p); !path.isEmpty() && !isRoot(path); path = parentFolder(path))
+            sum += path.size();
+        return sum + 1;
+    });
+    b.run("ancestors", "qt", c, [](const QString &p) {
+        const QStringList names = p.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+        qint64 sum = 0;
+        for (const QString &name : names)
+            sum += name.size();
+        return sum;
+    });
+    b.run("composeFilePath", "pathstr", c, [](const QString &p) { return composeFilePath(p, QStringLiteral(u"file"), QStringLiteral(u"txt")); });
+
+    b.run("root", "pathstr", c, [](const QString &p) { return root(p); });
+    b.run("root", "pathstr_view", c, [](const QString &p) { return rootView(p); });
+
+    b.run("suffix", "pathstr", c, [](const QString &p) { return suffix(p); });
+    b.run("suffix", "pathstr_view", c, [](const QString &p) { return suffixView(p); });
+    b.runUtf8("suffix", "pathstr_utf8", c, [](std::string_view p) { return core::suffix(p); });
+    b.run("suffix", "pathstr_lower_view", c, [&](const QString &p) { return lowerSuffixView(p, pathBuffer); });
+    b.run("suffix", "qt", c, [](const QString &p) { return QFileInfo(p).suffix().toLower(); });
+
+    b.run("completeSuffix", "pathstr", c, [](const QString &p) { return completeSuffix(p); });
+    b.run("completeSuffix", "pathstr_view", c, [](const QString &p) { return completeSuffixView(p); });
+    b.run("completeSuffix", "pathstr_lower_view", c, [&](const QString &p) { return lowerCompleteSuffixView(p, pathBuffer); });
+    b.run("completeSuffix", "qt", c, [](const QString &p) { return QFileInfo(p).completeSuffix().toLower(); });
+
+    b.run("setSuffix", "pathstr", c, [](const QString &p) { return setSuffix(p, QStringLiteral(u"zip")); });
+    b.run("suffixSize", "pathstr", c, [](const QString &p) { return suffixSize(p); });
+    b.run("completeSuffixSize", "pathstr", c, [](const QString &p) { return completeSuffixSize(p); });
+
+    b.run("hasExtension", "pathstr", c, [](const QString &p) { return hasExtension(p, QStringLiteral(u"tar.gz")); });
+    b.runUtf8("hasExtension", "pathstr_utf8", c, [](std::string_view p) { return core::hasExtension(p, std::string_view("tar.gz")); });
+    b.run("hasExtension", "qt", c, [](const QString &p) {
+        return QFileInfo(p).completeSuffix().compare(QStringLiteral(u"tar.gz"), Qt::CaseInsensitive) == 0;
+    });
+    b.run("hasExtension(list)", "pathstr", c, [&](const QString &p) { return hasExtension(p, extList); });
+    b.run("hasExtension(list)", "pathstr_set", c, [&](const QString &p) { return extSet.matches(p); });
+    b.run("hasExtension(list100)", "pathstr", c, [&](const QString &p) { return hasExtension(p, extList100); });
+    b.run("hasExtension(list100)", "pathstr_set", c, [&](const QString &p) { return extSet100.matches(p); });
+    b.run("hasExtension(list)", "qt", c, [&](const QString &p) {
+        const QFileInfo fi(p);
+        const QString suf = fi.suffix();
+        const QString csuf = fi.completeSuffix();
+        for (const QString &ext : extList) {
+            if (suf.compare(ext, Qt::CaseInsensitive) == 0 || csuf.compare(ext, Qt::CaseInsensitive) == 0)
+                return true;
+        }
+        return false;
+    });
+
+    b.run("hasWindowsRoot", "pathstr", c, [](const QString &p) { return hasWindowsRoot(p); });
+    b.run("isRoot", "pathstr", c, [](const QString &p) { return isRoot(p); });
+    b.run("isRoot", "qt", c, [](const QString &p) { return QDir(p).isRoot(); });
+    b.run("isAbsolute", "pathstr", c, [](const QString &p) { return isAbsolute(p); });
+    b.run("isAbsolute", "qt", c, [](const QString &p) { return QDir::isAbsolutePath(p); });
+    b.run("isRelative", "pathstr", c, [](const QString &p) { return isRelative(p); });
+    b.run("endsWithSep", "pathstr", c, [](const QString &p) { return endsWithSep(p); });
+    b.run("startsWithSep", "pathstr", c, [](const QString &p) { return startsWithSep(p); });
+    b.run("appendSep", "pathstr", c, [](const QString &p) { return appendSep(p); });
+    b.run("chopSep", "pathstr", c, [](const QString &p) { return chopSep(p); });
+
+    const PathGlob glob(QStringLiteral(u"**/folder*/*.t?t"));
+    const QRegularExpression globRx(QRegularExpression::wildcardToRegularExpression(glob.pattern()));
+    b.run("PathGlob::matches", "pathstr", c, [&](const QString &p) { return glob.matches(p); });
+    b.run("PathGlob::matches", "qt", c, [&](const QString &p) { return globRx.match(p).hasMatch(); });
+
+    // the parent folders of the corpus as the watched roots; the loop row checks each root
+    QStringList rootList;
+    for (const QString &p : c.paths)
+        rootList.append(parentFolder(p));
+    rootList.removeDuplicates();
+    const RootSet roots(rootList);
+    const QStringList rootList100 = rootList.mid(0, 100);
+    const RootSet roots100(rootList100);
+    b.run("RootSet::find", "pathstr", c, [&](const QString &p) { QStringView rel; roots.find(p, &rel); return rel; });
+    b.run("RootSet::find(100)", "pathstr", c, [&](const QString &p) { QStringView rel; roots100.find(p, &rel); return rel; });
+    b.run("RootSet::find(100)", "pathstr_loop", c, [&](const QString &p) {
+        QStringView deepest;
+        for (const QString &r : rootList100) {
+            const QStringView rel = relativePathView(r, p);
+            if (!rel.isNull() && (deepest.isNull() || rel.size() < deepest.size()))
+                deepest = rel;
+        }
+        return deepest;
+    });
+
+    // the "qt" rows hash the normalized strings, as is done without PathKey
+    const PathKey pathKey;
+    b.run("pathHash", "pathstr", c, [&](const QString &p) { return qint64(pathKey.hash(p)); });
+    b.run("pathHash", "qt", c, [](const QString &p) { return qint64(qHash(chopSep(QDir::fromNativeSeparators(p)))); });
+    b.run("pathHash(exact)", "pathstr", c, [](const QString &p) { return qint64(pathHash(p, PathKey::Exact)); });
+    b.run("pathHash(exact)", "qt", c, [](const QString &p) { return qint64(qHash(p)); });
+
+    const PathSet pathSet(c.paths);
+    QSet<QString> normalizedSet;
+    for (const QString &p : c.paths)
+        normalizedSet.insert(chopSep(QDir::fromNativeSeparators(p)));
+    b.run("PathSet::contains", "pathstr", c, [&](const QString &p) { return pathSet.contains(p); });
+    b.run("PathSet::contains", "qt", c, [&](const QString &p) { return normalizedSet.contains(chopSep(QDir::fromNativeSeparators(p))); });
+
+    // the hash quality: the collisions of the low bits, as used by the tables
+    std::vector<quint32> lowBits;
+    for (int i = 0; i < pathSet.size(); ++i)
+        lowBits.push_back(quint32(pathKey.hash(pathSet.path(i))) & 0xFFFFF);
+    std::sort(lowBits.begin(), lowBits.end());
+    const qint64 distinct = std::unique(lowBits.begin(), lowBits.end()) - lowBits.begin();
+    const double expected = pathSet.size() - 0x100000 * (1.0 - std::pow(1.0 - 1.0 / 0x100000, pathSet.size()));
+    std::fprintf(stderr, "pathHash %-12s %d paths, %lld collisions of 20 bits, %.1f expected\n", c.name,
+                 pathSet.size(), qint64(pathSet.size()) - distinct, expected);
+
+    // the corpus paths are mostly normal; the "dirty" rows need the actual work
+    const QString dirty = QStringLiteral(u"//a/./b/../file.txt");
+    QString buffer;
+    b.run("isNormalized", "pathstr", c, [](const QString &p) { return isNormalized(p); });
+    b.run("normalize", "pathstr", c, [](const QString &p) { return normalize(p); });
+    b.run("normalize", "qt", c, [](const QString &p) { return QDir::cleanPath(QDir::fromNativeSeparators(p)); });
+    b.run("normalize(dirty)", "pathstr", c, [&](const QString &p) { return normalize(QString(p + dirty)); });
+    b.run("normalize(dirty)", "pathstr_buffer", c, [&](const QString &p) { return normalize(QString(p + dirty), buffer).size(); });
+    b.run("normalize(dirty)", "qt", c, [&](const QString &p) { return QDir::cleanPath(QDir::fromNativeSeparators(QString(p + dirty))); });
+}
+
+/* The batch functions over a large corpus: the scaling curve from 1 thread
+ * to all hardware threads, the "pathstr" rows are the per-path loops.
+ */
+void runBatchAll(Bench &b, const Corpus &c)
+{
+    using namespace pathstr;
+    const ExtensionSet extSet({ "jpg", "png", "txt", "json", "tar.gz", "cpp", "h", "md" });
+    const PathGlob glob(QStringLiteral(u"**/folder*/*.t?t"));
+
+    // deep copies, the shared reference counters would be contended by the threads
+    Corpus large { c.name, c.root, {} };
+    large.paths.reserve(c.paths.size() * 50);
+    for (int i = 0; i < 50; ++i) {
+        for (const QString &path : c.paths)
+            large.paths.append(QString(path.constData(), path.size()));
+    }
+
+    b.runBatch("relativePaths", "pathstr", large, [&](const QStringList &paths) {
+        QStringList result;
+        result.reserve(paths.size());
+        for (const QString &path : paths)
+            result.append(relativePath(c.root, path));
+        return result;
+    });
+    b.runBatch("setSuffixes", "pathstr", large, [](const QStringList &paths) {
+        QStringList result;
+        result.reserve(paths.size());
+        for (const QString &path : paths)
+            result.append(setSuffix(path, QStringLiteral(u"zip")));
+        return result;
+    });
+    b.runBatch("filterByExtension", "pathstr", large, [&](const QStringList &paths) {
+        QStringList result;
+        for (const QString &path : paths) {
+            if (extSet.matches(path))
+                result.append(path);
+        }
+        return result;
+    });
+    b.runBatch("filterByGlob", "pathstr", large, [&](const QStringList &paths) {
+        QStringList result;
+        for (const QString &path : paths) {
+            if (glob.matches(path))
+                result.append(path);
+        }
+        return result;
+    });
+    // cut back by parentFolder() until every path is in it
+    b.runBatch("commonAncestor", "parentFolder_loop", large, [](const QStringList &paths) {
+        QString ancestor = chopSep(paths.first());
+        for (const QString &path : paths) {
+            while (!ancestor.isEmpty() && path != ancestor && !path.startsWith(appendSep(ancestor)))
+                ancestor = isRoot(ancestor) ? QString() : parentFolder(ancestor);
+        }
+        return ancestor;
+    });
+
+    // the path sizes stand for the file sizes
+    QVector<qint64> values;
+    values.reserve(large.paths.size());
+    for (const QString &path : large.paths)
+        values.append(path.size());
+
+    // per file: the complete suffix and every ancestor folder as a new string
+    b.measureCalls("aggregate", "qhash", large, large.paths.size(), [&]() {
+        const QStringList &paths = large.paths;
+        QHash<QString, qint64> byExtension;
+        QHash<QString, qint64> byFolder;
+        for (int i = 0; i < paths.size(); ++i) {
+            byExtension[completeSuffix(paths.at(i))] += values.at(i);
+            for (QString folder = parentFolder(paths.at(i)); !folder.isEmpty(); folder = parentFolder(folder)) {
+                byFolder[folder] += values.at(i);
+                if (isRoot(folder))
+                    break;
+            }
+        }
+        return byFolder.size() + byExtension.size();
+    });
+
+    // the next snapshot: every 5th path removed, every 7th one renamed
+    QStringList next;
+    next.reserve(large.paths.size());
+    for (int i = 0; i < large.paths.size(); ++i) {
+        if (i % 5 != 0)
+            next.append(large.paths.at(i));
+        if (i % 7 == 0)
+            next.append(large.paths.at(i) + QStringLiteral(u".new"));
+    }
+
+    b.runBatch("diffSnapshots", "qset", large, [&](const QStringList &paths) {
+        QSet<QString> before;
+        QSet<QString> after;
+        before.reserve(paths.size());
+        after.reserve(next.size());
+        for (const QString &path : paths)
+            before.insert(path);
+        for (const QString &path : next)
+            after.insert(path);
+
+        QStringList result;
+        for (const QString &path : next) {
+            if (!before.contains(path))
+                result.append(path);
+        }
+        for (const QString &path : paths) {
+            if (!after.contains(path))
+                result.append(path);
+        }
+        return result;
+    });
+
+    // the same number of distinct paths: each copy in its own folder under the root
+    Corpus distinct { c.name, c.root, {} };
+    distinct.paths.reserve(large.paths.size());
+    for (int i = 0; i < large.paths.size(); ++i) {
+        const QString &path = large.paths.at(i);
+        distinct.paths.append(path.left(c.root.size()) + QStringLiteral(u"/v") + QString::number(i / c.paths.size())
+                              + path.mid(c.root.size()));
+    }
+
+    b.runBatch("sortPaths", "std::sort", distinct, [](const QStringList &paths) {
+        QStringList result = paths;
+        std::sort(result.begin(), result.end(), [](const QString &path1, const QString &path2) {
+            return comparePaths(path1, path2) < 0;
+        });
+        return result;
+    });
+    b.runBatch("sortPaths(natural)", "std::sort", distinct, [](const QStringList &paths) {
+        QStringList result = paths;
+        std::sort(result.begin(), result.end(), [](const QString &path1, const QString &path2) {
+            return comparePaths(path1, path2, Qt::CaseInsensitive, true) < 0;
+        });
+        return result;
+    });
+
+    const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    for (int threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        const QByteArray impl = "pathstr_t" + QByteArray::number(threads);
+
+        b.runBatch("relativePaths", impl.constData(), large, [&](const QStringList &paths) {
+            return relativePaths(c.root, paths, threads);
+        });
+        b.runBatch("setSuffixes", impl.constData(), large, [&](const QStringList &paths) {
+            return setSuffixes(paths, QStringLiteral(u"zip"), threads);
+        });
+        b.runBatch("filterByExtension", impl.constData(), large, [&](const QStringList &paths) {
+            return filterByExtension(paths, extSet, threads);
+        });
+        b.runBatch("filterByGlob", impl.constData(), large, [&](const QStringList &paths) {
+            return filterByGlob(paths, glob, threads);
+        });
+        b.runBatch("sortPaths", impl.constData(), distinct, [&](const QStringList &paths) {
+            QStringList result = paths;
+            sortPaths(result, Qt::CaseSensitive, false, threads);
+            return result;
+        });
+        b.runBatch("sortPaths(natural)", impl.constData(), distinct, [&](const QStringList &paths) {
+            QStringList result = paths;
+            sortPaths(result, Qt::CaseInsensitive, true, threads);
+            return result;
+        });
+        b.runBatch("diffSnapshots", impl.constData(), large, [&](const QStringList &paths) {
+            return diffSnapshots(paths, next, threads).added;
+        });
+        b.runBatch("commonAncestor", impl.constData(), large, [&](const QStringList &paths) {
+            return commonAncestor(paths, threads);
+        });
+        b.measureCalls("aggregate", impl.constData(), large, large.paths.size(), [&]() {
+            const PathAggregator agg = aggregate(large.paths, values, threads);
+            return agg.recursive(0).count + agg.extensionCount();
+        });
+
+        if (threads == maxThreads)
+            break;
+    }
+}
+
+/* walk() against QDirIterator on a tree of <files> files: 16 * 16 folders of 16 subfolders,
+ * the files spread evenly over the 4096 leaves. The tree is read once before, so the
+ * folders are in the page cache and the walk itself is measured.
+ */
+void runWalkAll(Bench &b, int files)
+{
+    using namespace pathstr;
+    if (!b.filter.isEmpty() && !QStringLiteral(u"walk.filterByExtension").contains(b.filter))
+        return;
+
+    const QTemporaryDir dir;
+    const QString root = dir.path();
+    const int leaves = 16 * 16 * 16;
+
+    for (int leaf = 0; leaf < leaves; ++leaf) {
+        const QString folder = QStringLiteral(u"d%1/d%2/d%3").arg(leaf / 256).arg(leaf / 16 % 16).arg(leaf % 16);
+        QDir(root).mkpath(folder);
+
+        for (int i = leaf; i < files; i += leaves) {
+            const QString fileName = root + s_sep + folder + s_sep + QString::fromLatin1(s_names[i % 8])
+                                     + QString::number(i) + s_dot + QString::fromLatin1(s_suffixes[i % 8]);
+            if (std::FILE *file = std::fopen(qPrintable(fileName), "wb"))
+                std::fclose(file);
+        }
+    }
+
+    const std::string name = "tree_" + std::to_string(files);
+    const Corpus tree { name.c_str(), root, {} };
+    const qint64 entries = walkPaths(root).size();
+    const ExtensionSet extSet({ "jpg", "txt" });
+
+    b.measureCalls("walk", "pathstr", tree, entries, [&]() {
+        std::atomic<qint64> count { 0 };
+        walk(root, [&](const WalkEntry &) { count.fetch_add(1, std::memory_order_relaxed); });
+        return count.load();
+    });
+
+    WalkOptions single;
+    single.threads = 1;
+    b.measureCalls("walk", "pathstr_1thread", tree, entries, [&]() {
+        qint64 count = 0;
+        walk(root, [&](const WalkEntry &) { ++count; }, single);
+        return count;
+    });
+
+    b.measureCalls("walk", "pathstr_queue", tree, entries, [&]() {
+        WalkQueue queue(root);
+        WalkEntry entry;
+        qint64 size = 0;
+        while (queue.next(entry))
+            size += entry.path.size();
+        return size;
+    });
+
+    b.measureCalls("walk", "pathstr_list", tree, entries, [&]() { return walkPaths(root).size(); });
+
+    b.measureCalls("walk", "qt", tree, entries, [&]() {
+        QDirIterator it(root, QDir::AllEntries | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                        QDirIterator::Subdirectories);
+        qint64 size = 0;
+        while (it.hasNext())
+            size += it.next().size();
+        return size;
+    });
+
+    // the files with the extensions only
+    WalkOptions filtered;
+    filtered.extensions = &extSet;
+    filtered.folders = false;
+    b.measureCalls("walk.filterByExtension", "pathstr", tree, entries, [&]() {
+        std::atomic<qint64> count { 0 };
+        walk(root, [&](const WalkEntry &) { count.fetch_add(1, std::memory_order_relaxed); }, filtered);
+        return count.load();
+    });
+
+    b.measureCalls("walk.filterByExtension", "qt", tree, entries, [&]() {
+        QDirIterator it(root, { "*.jpg", "*.txt" }, QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                        QDirIterator::Subdirectories);
+        qint64 count = 0;
+        while (it.hasNext()) {
+            it.next();
+            ++count;
+        }
+        return count;
+    });
+}
+
+#ifdef PATHSTR_PROFILE
+/* The same calls with the counting paused and running: the overhead of PATHSTR_PROFILE.
+ * Without the option, the instrumentation expands to nothing.
+ */
+void runProfileAll(Bench &b, const Corpus &c)
+{
+    using namespace pathstr;
+    const QString add = QStringLiteral(u"child/file.txt");
+
+    for (const bool enabled : { false, true }) {
+        const char *impl = enabled ? "pathstr_profiled" : "pathstr_paused";
+        profile::setEnabled(enabled);
+
+        b.run("profile.isAbsolute", impl, c, [](const QString &p) { return isAbsolute(p); });
+        b.run("profile.entryNameView", impl, c, [](const QString &p) { return entryNameView(p); });
+        b.run("profile.entryName", impl, c, [](const QString &p) { return entryName(p); });
+        b.run("profile.suffix", impl, c, [](const QString &p) { return suffix(p); });
+        b.run("profile.joinPath", impl, c, [&](const QString &p) { return joinPath(p, add); });
+        b.run("profile.normalize", impl, c, [](const QString &p) { return normalize(p); });
+    }
+
+    profile::setEnabled(true);
+}
+#endif
+
+/* PathBuffer against the QStringList over 50 deep copies of the corpus (a heap block per path,
+ * as in a list read from a file): the memory, a sequential scan and the batch functions,
+ * in a single thread so that the memory layout makes the difference.
+ */
+void runBufferAll(Bench &b, const Corpus &c)
+{
+    using namespace pathstr;
+    const ExtensionSet extSet({ "jpg", "png", "txt", "json", "tar.gz", "cpp", "h", "md" });
+
+    Corpus large { c.name, c.root, {}, {} };
+    large.paths.reserve(c.paths.size() * 50);
+    for (int i = 0; i < 50; ++i) {
+        for (const QString &path : c.paths)
+            large.paths.append(QString(path.constData(), path.size()));
+    }
+
+    const PathBuffer buffer(large.paths);
+    const int count = large.paths.size();
+
+    // QString: the list item, the data header and the text with the terminating null
+    qint64 listBytes = 0;
+    for (const QString &path : large.paths)
+        listBytes += qint64(sizeof(QString)) + 16 + (path.size() + 1) * qint64(sizeof(QChar));
+
+    std::fprintf(stderr, "PathBuffer %-12s %8.1f bytes/path, QStringList %8.1f bytes/path\n", c.name,
+                 double(buffer.memoryUsage()) / count, double(listBytes) / count);
+
+    b.measureCalls("buffer.scan", "qstringlist", large, count, [&]() {
+        qint64 found = 0;
+        for (const QString &path : large.paths)
+            found += extSet.matches(path);
+        return found;
+    });
+    b.measureCalls("buffer.scan", "pathbuffer", large, count, [&]() {
+        qint64 found = 0;
+        for (QStringView path : buffer)
+            found += extSet.matches(path);
+        return found;
+    });
+
+    b.runBatch("buffer.relativePaths", "qstringlist", large, [&](const QStringList &paths) {
+        return relativePaths(c.root, paths, 1);
+    });
+    b.measureCalls("buffer.relativePaths", "pathbuffer", large, count, [&]() {
+        return relativePaths(c.root, buffer, 1).size();
+    });
+    b.runBatch("buffer.setSuffixes", "qstringlist", large, [](const QStringList &paths) {
+        return setSuffixes(paths, QStringLiteral(u"zip"), 1);
+    });
+    b.measureCalls("buffer.setSuffixes", "pathbuffer", large, count, [&]() {
+        return setSuffixes(buffer, QStringLiteral(u"zip"), 1).size();
+    });
+    b.runBatch("buffer.entryNames", "qstringlist", large, [](const QStringList &paths) {
+        QStringList result;
+        result.reserve(paths.size());
+        for (const QString &path : paths)
+            result.append(entryNameView(path).toString());
+        return result;
+    });
+    b.measureCalls("buffer.entryNames", "pathbuffer", large, count, [&]() {
+        return entryNames(buffer, 1).size();
+    });
+    b.runBatch("buffer.filterByExtension", "qstringlist", large, [&](const QStringList &paths) {
+        return filterByExtension(paths, extSet, 1);
+    });
+    b.measureCalls("buffer.filterByExtension", "pathbuffer", large, count, [&]() {
+        return filterByExtension(buffer, extSet, 1).size();
+    });
+}
+
+/* PathTree over the corpus: the inserts, the queries on the handles
+ * and the memory compared to the list of QStrings.
+ */
+void runTreeAll(Bench &b, const Corpus &c)
+{
+    using namespace pathstr;
+    PathTree tree;
+    const QVector<PathTree::Handle> handles = tree.insert(c.paths);
+    const PathTree::Handle rootHandle = tree.find(c.root);
+
+    // QString: the list item, the data header and the text with the terminating null
+    qint64 listBytes = 0;
+    for (const QString &path : c.paths)
+        listBytes += qint64(sizeof(QString)) + 16 + (path.size() + 1) * qint64(sizeof(QChar));
+
+    std::fprintf(stderr, "PathTree %-12s %8.1f bytes/path, QStringList %8.1f bytes/path\n", c.name,
+                 double(tree.memoryUsage()) / c.paths.size(), double(listBytes) / c.paths.size());
+
+    int ind = 0;
+    auto next = [&]() { ind = (ind + 1 < handles.size()) ? ind + 1 : 0; return handles.at(ind); };
+
+    b.run("PathTree::insert", "pathstr", c, [](const QString &p) {
+        static PathTree fresh;
+        return qint64(fresh.insert(p));
+    });
+    b.run("PathTree::path", "pathstr", c, [&](const QString &) { return tree.path(next()); });
+    b.run("PathTree::parent", "pathstr", c, [&](const QString &) { return qint64(tree.parent(next())); });
+    b.run("PathTree::relativePath", "pathstr", c, [&](const QString &) { return tree.relativePath(rootHandle, next()); });
+    b.run("PathTree::isAncestor", "pathstr", c, [&](const QString &) { return tree.isAncestor(rootHandle, next()); });
+}
+
+/* The streaming operations over a mapped UTF-8 list of the corpus paths,
+ * the results go to a counter or to a PathListWriter.
+ */
+void runStreamAll(Bench &b, const Corpus &c)
+{
+    using namespace pathstr::core;
+    const QTemporaryDir dir;
+    const std::string fileName = dir.filePath(QStringLiteral(u"list.txt")).toStdString();
+    const std::string outName = dir.filePath(QStringLiteral(u"out.txt")).toStdString();
+    const std::string rootUtf8 = c.root.toStdString();
+    qint64 lines = 0;
+
+    {
+        PathListWriter writer(fileName);
+        for (int i = 0; i < 20; ++i) {
+            for (const std::string &path : c.utf8)
+                writer(path);
+        }
+        lines = 20 * static_cast<qint64>(c.utf8.size());
+    }
+
+    const MappedPathList list(fileName);
+
+    b.runStream("stream.forEachLine", "pathstr_mapped", c, list, lines, [](const MappedPathList &l) {
+        qint64 size = 0;
+        l.forEachLine([&](std::string_view path) { size += path.size(); });
+        return size;
+    });
+    const ExtensionSet extSet({ "jpg", "txt", "tar.gz" });
+    b.runStream("stream.filterByExtension", "pathstr_mapped", c, list, lines, [&](const MappedPathList &l) {
+        qint64 count = 0;
+        filterByExtension(l, extSet, [&](std::string_view) { ++count; });
+        return count;
+    });
+    b.runStream("stream.relativePaths", "pathstr_mapped", c, list, lines, [&](const MappedPathList &l) {
+        PathListWriter writer(outName);
+        relativePaths(l, rootUtf8, writer);
+        return qint64(writer.flush());
+    });
+    b.runStream("stream.setSuffixes", "pathstr_mapped", c, list, lines, [&](const MappedPathList &l) {
+        PathListWriter writer(outName);
+        setSuffixes(l, "zip", writer);
+        return qint64(writer.flush());
+    });
+    b.runStream("stream.groupByParent", "pathstr_mapped", c, list, lines, [](const MappedPathList &l) {
+        qint64 groups = 0;
+        groupByParent(l, [&](std::string_view, const std::vector<std::string_view> &) { ++groups; });
+        return groups;
+    });
+}
+
+/*** Output ***/
+void writeCsv(std::FILE *out, const std::vector<Result> &results)
+{
+    std::fprintf(out, "function,corpus,impl,ns_per_op,allocs_per_op\n");
+
+    for (const Result &r : results) {
+        std::fprintf(out, "%s,%s,%s,%.2f,%.3f\n", qPrintable(r.function), qPrintable(r.corpus),
+                     qPrintable(r.impl), r.nsPerOp, r.allocsPerOp);
+    }
+}
+
+void writeJson(std::FILE *out, const std::vector<Result> &results)
+{
+    std::fprintf(out, "{\n  \"benchmarks\": [\n");
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        std::fprintf(out, "    { \"function\": \"%s\", \"corpus\": \"%s\", \"impl\": \"%s\", "
+                          "\"ns_per_op\": %.2f, \"allocs_per_op\": %.3f }%s\n",
+                     qPrintable(r.function), qPrintable(r.corpus), qPrintable(r.impl),
+                     r.nsPerOp, r.allocsPerOp, (i + 1 < results.size()) ? "," : "");
+    }
+
+    std::fprintf(out, "  ]\n}\n");
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Bench bench;
+    bool json = false;
+    const char *outFile = nullptr;
+    const char *profileFile = nullptr;
+    int walkFiles = 100000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json")) {
+            json = true;
+        } else if (!std::strcmp(argv[i], "--csv")) {
+            json = false;
+        } else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            bench.minTimeNs = std::atoll(argv[++i]) * 1000000LL;
+        } else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            bench.filter = QString::fromLocal8Bit(argv[++i]);
+        } else if (!std::strcmp(argv[i], "-o") && i + 1 < argc) {
+            outFile = argv[++i];
+        } else if (!std::strcmp(argv[i], "--profile") && i + 1 < argc) {
+            profileFile = argv[++i];
+        } else if (!std::strcmp(argv[i], "--walk-files") && i + 1 < argc) {
+            walkFiles = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--csv | --json] [--min-time <ms>] [--filter <text>] [-o <file>] "
+                                 "[--profile <file>] [--walk-files <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::fprintf(stderr, "scan kernels: %s\n", pathstr::simd::backend());
+    std::fprintf(stderr, "profile: %s\n", pathstr::profile::isAvailable() ? "on" : "off");
+
+    if (profileFile && !pathstr::profile::isAvailable()) {
+        std::fprintf(stderr, "--profile: built without PATHSTR_PROFILE\n");
+        return 1;
+    }
+
+    pathstr::profile::setAllocationCounter(BENCH_COUNT_ALLOCS ? allocCount : nullptr);
+
+    for (const Corpus &corpus : makeCorpora()) {
+        runAll(bench, corpus);
+        runBatchAll(bench, corpus);
+        runStreamAll(bench, corpus);
+        runTreeAll(bench, corpus);
+        runBufferAll(bench, corpus);
+#ifdef PATHSTR_PROFILE
+        runProfileAll(bench, corpus);
+#endif
+    }
+
+    runWalkAll(bench, walkFiles);
+
+    if (profileFile) {
+        std::FILE *profileOut = std::fopen(profileFile, "w");
+        if (!profileOut) {
+            std::fprintf(stderr, "Cannot open %s\n", profileFile);
+            return 1;
+        }
+
+        const QByteArray profileJson = pathstr::profile::snapshot().toJson();
+        std::fwrite(profileJson.constData(), 1, profileJson.size(), profileOut);
+        std::fclose(profileOut);
+    }
+
+    std::FILE *out = outFile ? std::fopen(outFile, "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "Cannot open %s\n", outFile);
+        return 1;
+    }
+
+    json ? writeJson(out, bench.results) : writeCsv(out, bench.results);
+
+    if (out != stdout)
+        std::fclose(out);
+
+    return 0;
+}
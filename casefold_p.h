@@ -0,0 +1,41 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef CASEFOLD_P_H
+#define CASEFOLD_P_H
+
+/* Internal, not a part of the API: the ASCII case folding of the scanning kernels,
+ * the key hashes and the Qt-free core. See foldCase() (pathstr_p.h) for the full one.
+ */
+
+namespace pathstr {
+namespace core {
+namespace detail {
+// 'A'-'Z' -> 'a'-'z' of a UTF-16 code unit or a UTF-8 byte, the other units are kept
+template <typename Char>
+constexpr Char foldAscii(Char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? Char(ch | 0x20) : ch;
+}
+
+// foldAscii() for the core templates: BasicExtensionSet<std::string_view, FoldAscii>
+struct FoldAscii
+{
+    template <typename Char>
+    constexpr Char operator()(Char ch) const { return foldAscii(ch); }
+};
+
+} // namespace detail
+} // namespace core
+} // namespace pathstr
+
+#endif // CASEFOLD_P_H
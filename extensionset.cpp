@@ -0,0 +1,63 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+
+#include "extensionset.h"
+#include "pathstr_p.h"
+
+namespace pathstr {
+char16_t FoldCase::operator()(char16_t ch) const
+{
+    return foldCase(ch);
+}
+
+namespace core {
+template class BasicExtensionSet<QStringView, FoldCase>;
+} // namespace core
+
+ExtensionSet::ExtensionSet(const QStringList &extensions)
+{
+    for (const QString &ext : extensions)
+        insert(ext);
+}
+
+void ExtensionSet::insert(QStringView ext)
+{
+    m_set.insert(ext);
+}
+
+bool ExtensionSet::contains(QStringView ext) const
+{
+    return m_set.contains(ext);
+}
+
+bool ExtensionSet::matches(QStringView fileName) const
+{
+    return m_set.matches(fileName);
+}
+
+int ExtensionSet::size() const
+{
+    return m_set.size();
+}
+
+bool ExtensionSet::isEmpty() const
+{
+    return m_set.isEmpty();
+}
+
+bool hasExtension(const QString &fileName, const ExtensionSet &extensions)
+{
+    return extensions.matches(fileName);
+}
+
+} // namespace pathstr
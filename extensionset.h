@@ -0,0 +1,72 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef EXTENSIONSET_H
+#define EXTENSIONSET_H
+
+#include "hashtable_p.h"
+#include "pathinfo.h"
+#include "pathstr.h"
+#include <QStringList>
+
+namespace pathstr {
+// foldCase() (pathstr_p.h) as the fold of the set; the set is instantiated in extensionset.cpp, where it's inlined
+struct FoldCase
+{
+    char16_t operator()(char16_t ch) const;
+};
+
+namespace core {
+extern template class BasicExtensionSet<QStringView, FoldCase>;
+} // namespace core
+
+/* A set of file extensions, precompiled for fast matching of many paths.
+ * Matching gives the same results as hasExtension(fileName, extensions),
+ * but costs a single backward scan of the file name suffixes instead of
+ * an endsWith() call for every listed extension (core::BasicExtensionSet).
+ *
+ * const ExtensionSet set({ "jpg", ".PNG", "tar.gz" });
+ * set.matches("/folder/photo.png")       -> true
+ * set.matches("/folder/archive.TAR.GZ")  -> true
+ * set.matches("/folder/file.txt")        -> false
+ */
+class ExtensionSet
+{
+public:
+    ExtensionSet() = default;
+    explicit ExtensionSet(const QStringList &extensions);
+
+    // Adds the <ext>, the leading dot is removed: ".TXT" and "txt" are the same extension.
+    // An empty <ext> matches file names without a suffix.
+    void insert(QStringView ext);
+
+    // true if the <ext> is in the set (case insensitive, the leading dot is ignored)
+    bool contains(QStringView ext) const;
+
+    // true if the <fileName> has any extension from the set
+    bool matches(QStringView fileName) const;
+
+    int size() const;
+    bool isEmpty() const;
+
+private:
+    core::BasicExtensionSet<QStringView, FoldCase> m_set;
+};
+
+/* True if the <fileName> has any extension from the set
+ * hasExtension("file.txt", ExtensionSet({"jpg", "txt", "json"})) -> true
+ */
+bool hasExtension(const QString &fileName, const ExtensionSet &extensions);
+
+} // namespace pathstr
+
+#endif // EXTENSIONSET_H
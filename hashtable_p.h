@@ -0,0 +1,291 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef HASHTABLE_P_H
+#define HASHTABLE_P_H
+
+#include "pathcore.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/* Internal, not a part of the API: the hashing and the index table of the sets
+ * and the trees, and the extension set used through ExtensionSet (extensionset.h).
+ */
+
+namespace pathstr {
+namespace core {
+namespace detail {
+/*** FNV-1a ***/
+// One step per code unit: a hash can be built up during a scan of the string
+static const uint32_t s_fnvOffset = 2166136261u;
+static const uint32_t s_fnvPrime = 16777619u;
+
+template <typename Char>
+inline uint32_t hashStep(uint32_t hash, Char ch)
+{
+    return (hash ^ static_cast<std::make_unsigned_t<Char>>(ch)) * s_fnvPrime;
+}
+
+template <typename Char>
+inline uint32_t hashUnits(const Char *data, size_t size)
+{
+    uint32_t hash = s_fnvOffset;
+
+    for (size_t i = 0; i < size; ++i)
+        hash = hashStep(hash, data[i]);
+
+    return hash;
+}
+
+// From the end, each unit passed through the <fold>: the suffix hashes of a backward scan
+template <typename Char, typename Fold>
+inline uint32_t hashUnitsBack(const Char *data, size_t size, Fold fold)
+{
+    uint32_t hash = s_fnvOffset;
+
+    for (size_t i = size; i > 0; --i)
+        hash = hashStep(hash, fold(data[i - 1]));
+
+    return hash;
+}
+
+/*** HashIndex ***/
+/* The hash index of the items stored elsewhere (by their int index): open addressing
+ * with linear probing, a power of two size, the load factor at most 1/2. The slots keep
+ * the hashes, so growing does not rehash the items.
+ */
+class HashIndex
+{
+public:
+    // The item with the <hash> for which <equals(index)> is true, -1 if there is none
+    template <typename Equals>
+    int find(uint32_t hash, Equals equals) const
+    {
+        if (m_slots.empty())
+            return -1;
+
+        const size_t mask = m_slots.size() - 1;
+
+        for (size_t i = hash & mask; m_slots[i].index != -1; i = (i + 1) & mask) {
+            if (m_slots[i].hash == hash && equals(m_slots[i].index))
+                return m_slots[i].index;
+        }
+
+        return -1;
+    }
+
+    // Adds the item, it must not be in the index yet
+    void insert(uint32_t hash, int index)
+    {
+        reserve(m_count + 1);
+        place(hash, index);
+        ++m_count;
+    }
+
+    // The room for <count> items
+    void reserve(size_t count)
+    {
+        if (count * 2 <= m_slots.size())
+            return;
+
+        size_t capacity = m_slots.empty() ? 16 : m_slots.size();
+        while (count * 2 > capacity)
+            capacity *= 2;
+
+        std::vector<Slot> old(capacity, Slot { 0, -1 });
+        old.swap(m_slots);
+
+        for (const Slot &slot : old) {
+            if (slot.index != -1)
+                place(slot.hash, slot.index);
+        }
+    }
+
+    size_t memoryUsage() const { return m_slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        int index; // -1 if the slot is empty
+    };
+
+    void place(uint32_t hash, int index)
+    {
+        const size_t mask = m_slots.size() - 1;
+        size_t i = hash & mask;
+
+        while (m_slots[i].index != -1)
+            i = (i + 1) & mask;
+
+        m_slots[i] = { hash, index };
+    }
+
+    std::vector<Slot> m_slots;
+    size_t m_count = 0;
+};
+
+} // namespace detail
+
+/*** BasicExtensionSet ***/
+/* A set of file extensions, precompiled for matching many paths: the same results as
+ * hasExtension(path, ext) for any of them, but a single backward scan of the suffixes
+ * and a hash lookup per dot instead of a comparison per extension. The code units
+ * are compared as folded by the <Fold> functor: (Char ch) -> the case-folded ch.
+ */
+template <typename View, typename Fold>
+class BasicExtensionSet
+{
+public:
+    typedef typename ViewTraits<View>::Char Char;
+
+    // The leading dot is removed: ".TXT" and "txt" are the same extension.
+    // An empty <ext> matches file names without a suffix.
+    void insert(View ext);
+
+    // true if the <ext> is in the set (case insensitive, the leading dot is ignored)
+    bool contains(View ext) const;
+
+    // true if the <path> has any extension from the set
+    bool matches(View path) const;
+
+    int size() const { return static_cast<int>(m_exts.size()) + (m_matchNoSuffix ? 1 : 0); }
+    bool isEmpty() const { return size() == 0; }
+
+private:
+    typedef ViewTraits<View> Traits;
+
+    bool find(const Char *key, int size, uint32_t hash) const;
+
+    std::vector<std::basic_string<Char>> m_exts; // case-folded, without the leading dot
+    detail::HashIndex m_index;                   // of m_exts, by the backward hashes
+    int m_maxDots = 0;                           // the number of dots to check in the path: "tar.gz" -> 2
+    bool m_matchNoSuffix = false;
+};
+
+template <typename View, typename Fold>
+void BasicExtensionSet<View, Fold>::insert(View ext)
+{
+    const Char *key = Traits::data(ext);
+    int size = Traits::size(ext);
+
+    if (size == 0) {
+        m_matchNoSuffix = true;
+        return;
+    }
+
+    if (key[0] == '.') {
+        ++key;
+        --size;
+    }
+
+    // the key is hashed from the end: the path hash is built up during the backward scan
+    const uint32_t hash = detail::hashUnitsBack(key, size, Fold());
+
+    if (find(key, size, hash))
+        return;
+
+    const Fold fold;
+    std::basic_string<Char> folded(size, Char());
+    int dots = 1;
+
+    for (int i = 0; i < size; ++i) {
+        folded[i] = fold(key[i]);
+        if (key[i] == '.')
+            ++dots;
+    }
+
+    if (dots > m_maxDots)
+        m_maxDots = dots;
+
+    m_exts.push_back(std::move(folded));
+    m_index.insert(hash, static_cast<int>(m_exts.size()) - 1);
+}
+
+template <typename View, typename Fold>
+bool BasicExtensionSet<View, Fold>::contains(View ext) const
+{
+    const Char *key = Traits::data(ext);
+    int size = Traits::size(ext);
+
+    if (size == 0)
+        return m_matchNoSuffix;
+
+    if (key[0] == '.') {
+        ++key;
+        --size;
+    }
+
+    return find(key, size, detail::hashUnitsBack(key, size, Fold()));
+}
+
+template <typename View, typename Fold>
+bool BasicExtensionSet<View, Fold>::matches(View path) const
+{
+    if (m_matchNoSuffix && BasicPathInfo<View>(path).suffixSize() == 0)
+        return true;
+
+    if (m_exts.empty())
+        return false;
+
+    const Char *data = Traits::data(path);
+    const int size = Traits::size(path);
+    const Fold fold;
+    uint32_t hash = detail::s_fnvOffset;
+    int dots = 0;
+
+    // hasExtension(): the dot at the beginning of the string is not a suffix dot
+    for (int i = size - 1; i > 0; --i) {
+        const Char ch = data[i];
+
+        if (ch == '.') {
+            if (find(data + i + 1, size - i - 1, hash))
+                return true;
+
+            if (++dots == m_maxDots)
+                break;
+        } else if (isSeparator(ch)) {
+            break;
+        }
+
+        hash = detail::hashStep(hash, fold(ch));
+    }
+
+    return false;
+}
+
+template <typename View, typename Fold>
+bool BasicExtensionSet<View, Fold>::find(const Char *key, int size, uint32_t hash) const
+{
+    const Fold fold;
+
+    return m_index.find(hash, [&](int index) {
+        const std::basic_string<Char> &folded = m_exts[index];
+
+        if (folded.size() != static_cast<size_t>(size))
+            return false;
+
+        for (int i = 0; i < size; ++i) {
+            if (fold(key[i]) != folded[i])
+                return false;
+        }
+
+        return true;
+    }) != -1;
+}
+
+} // namespace core
+} // namespace pathstr
+
+#endif // HASHTABLE_P_H
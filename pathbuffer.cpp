@@ -0,0 +1,128 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathbuffer.h"
+#include "pathlist.h"
+#include <QFile>
+
+namespace pathstr {
+PathBuffer::PathBuffer()
+    : m_offsets(1, 0)
+{}
+
+PathBuffer::PathBuffer(const QStringList &paths)
+    : m_offsets(1, 0)
+{
+    qint64 size = 0;
+    for (const QString &path : paths)
+        size += path.size();
+
+    reserve(paths.size(), size);
+
+    for (const QString &path : paths)
+        append(path);
+}
+
+PathBuffer PathBuffer::fromFile(const QString &fileName, bool *ok)
+{
+    PathBuffer buffer;
+    const core::MappedPathList list(QFile::encodeName(fileName).toStdString());
+
+    if (ok)
+        *ok = list.isOpen();
+
+    // a UTF-8 byte gives at most one UTF-16 code unit
+    buffer.m_data.reserve(list.data().size());
+    list.forEachLine([&](std::string_view line) { buffer.appendUtf8(line); });
+
+    return buffer;
+}
+
+void PathBuffer::reserve(int count, qint64 size)
+{
+    m_offsets.reserve(count + 1);
+    m_data.reserve(size);
+}
+
+void PathBuffer::clear()
+{
+    m_data.clear();
+    m_offsets.resize(1);
+}
+
+void PathBuffer::append(QStringView path)
+{
+    const char16_t *data = path.utf16();
+    m_data.insert(m_data.end(), data, data + path.size());
+    m_offsets.push_back(static_cast<qint64>(m_data.size()));
+}
+
+void PathBuffer::append(std::initializer_list<QStringView> parts)
+{
+    for (QStringView part : parts)
+        m_data.insert(m_data.end(), part.utf16(), part.utf16() + part.size());
+
+    m_offsets.push_back(static_cast<qint64>(m_data.size()));
+}
+
+void PathBuffer::append(const PathBuffer &other)
+{
+    const qint64 shift = dataSize();
+
+    m_data.insert(m_data.end(), other.m_data.begin(), other.m_data.end());
+
+    m_offsets.reserve(m_offsets.size() + other.size());
+    for (size_t i = 1; i < other.m_offsets.size(); ++i)
+        m_offsets.push_back(other.m_offsets[i] + shift);
+}
+
+void PathBuffer::appendUtf8(std::string_view path)
+{
+    const size_t start = m_data.size();
+    m_data.resize(start + path.size());
+    char16_t *out = m_data.data() + start;
+
+    for (size_t i = 0; i < path.size(); ++i) {
+        const unsigned char ch = static_cast<unsigned char>(path[i]);
+
+        if (ch >= 0x80) {
+            // not ASCII: the decoded string replaces the widened units
+            const QString decoded = QString::fromUtf8(path.data(), static_cast<int>(path.size()));
+            const char16_t *data = QStringView(decoded).utf16();
+            m_data.resize(start);
+            m_data.insert(m_data.end(), data, data + decoded.size());
+            break;
+        }
+
+        out[i] = ch;
+    }
+
+    m_offsets.push_back(static_cast<qint64>(m_data.size()));
+}
+
+qint64 PathBuffer::memoryUsage() const
+{
+    return static_cast<qint64>(m_data.capacity() * sizeof(char16_t) + m_offsets.capacity() * sizeof(qint64));
+}
+
+QStringList PathBuffer::toStringList() const
+{
+    QStringList list;
+    list.reserve(size());
+
+    for (QStringView path : *this)
+        list.append(path.toString());
+
+    return list;
+}
+
+} // namespace pathstr
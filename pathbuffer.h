@@ -0,0 +1,141 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHBUFFER_H
+#define PATHBUFFER_H
+
+#include <QStringList>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+namespace pathstr {
+/* A columnar path list: the code units of all paths in one contiguous blob and the offsets
+ * of the paths in it. A path costs its size and 8 bytes of the offset, there is no heap block
+ * (with its header and reference counter) per path, and a scan reads the memory sequentially.
+ * The batch functions of batch.h take and return it, see "Columnar batch processing".
+ *
+ * PathBuffer buffer = PathBuffer::fromFile("inventory.txt");
+ * for (QStringView path : buffer)
+ *     ...
+ * PathBuffer names = entryNames(buffer);
+ * names.toStringList(); // only if the QString objects are needed
+ *
+ * The views are valid until the next change of the buffer.
+ */
+class PathBuffer
+{
+public:
+    class const_iterator
+    {
+    public:
+        // it->size(): the view is made on the fly, the proxy holds it
+        struct pointer
+        {
+            QStringView view;
+            const QStringView *operator->() const { return &view; }
+        };
+
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef QStringView value_type;
+        typedef int difference_type;
+        typedef QStringView reference;
+
+        const_iterator() = default;
+        const_iterator(const PathBuffer *buffer, int index) : m_buffer(buffer), m_index(index) {}
+
+        QStringView operator*() const { return m_buffer->at(m_index); }
+        pointer operator->() const { return { m_buffer->at(m_index) }; }
+        QStringView operator[](int n) const { return m_buffer->at(m_index + n); }
+
+        const_iterator &operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { return const_iterator(m_buffer, m_index++); }
+        const_iterator &operator--() { --m_index; return *this; }
+        const_iterator operator--(int) { return const_iterator(m_buffer, m_index--); }
+        const_iterator &operator+=(int n) { m_index += n; return *this; }
+        const_iterator &operator-=(int n) { m_index -= n; return *this; }
+        const_iterator operator+(int n) const { return const_iterator(m_buffer, m_index + n); }
+        const_iterator operator-(int n) const { return const_iterator(m_buffer, m_index - n); }
+        friend const_iterator operator+(int n, const_iterator it) { return it + n; }
+        int operator-(const_iterator other) const { return m_index - other.m_index; }
+
+        bool operator==(const_iterator other) const { return m_index == other.m_index; }
+        bool operator!=(const_iterator other) const { return m_index != other.m_index; }
+        bool operator<(const_iterator other) const { return m_index < other.m_index; }
+        bool operator>(const_iterator other) const { return m_index > other.m_index; }
+        bool operator<=(const_iterator other) const { return m_index <= other.m_index; }
+        bool operator>=(const_iterator other) const { return m_index >= other.m_index; }
+
+    private:
+        const PathBuffer *m_buffer = nullptr;
+        int m_index = 0;
+    };
+
+    PathBuffer();
+    explicit PathBuffer(const QStringList &paths);
+
+    /* The lines of a newline-separated UTF-8 list (MappedPathList), the empty ones skipped.
+     * The file is mapped and decoded straight into the blob. <ok> is false if it can't be opened.
+     */
+    static PathBuffer fromFile(const QString &fileName, bool *ok = nullptr);
+
+    // The room for <count> paths of <size> code units in total
+    void reserve(int count, qint64 size);
+
+    // Removes the paths, the capacity is kept
+    void clear();
+
+    // The <path> must not be a view into this buffer
+    void append(QStringView path);
+
+    // The <parts> joined into one path: append({ folder, u"/", name })
+    void append(std::initializer_list<QStringView> parts);
+
+    void append(const PathBuffer &other);
+
+    // Decoded from UTF-8, ASCII is widened without a temporary string
+    void appendUtf8(std::string_view path);
+
+    // A sink of the streaming operations of pathlist.h: relativePaths(list, root, buffer)
+    void operator()(std::string_view path) { appendUtf8(path); }
+
+    // The number of paths
+    int size() const { return static_cast<int>(m_offsets.size()) - 1; }
+    bool isEmpty() const { return m_offsets.size() == 1; }
+
+    QStringView at(int i) const
+    {
+        return QStringView(m_data.data() + m_offsets[i], static_cast<int>(m_offsets[i + 1] - m_offsets[i]));
+    }
+    QStringView operator[](int i) const { return at(i); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // The code units of all paths, one after another
+    const char16_t *data() const { return m_data.data(); }
+    qint64 dataSize() const { return m_offsets.back(); }
+
+    // The bytes allocated by the buffer: the capacity of the blob and of the offsets
+    qint64 memoryUsage() const;
+
+    QStringList toStringList() const;
+
+private:
+    std::vector<char16_t> m_data;
+    std::vector<qint64> m_offsets; // the start of each path, then the end of the last one
+};
+
+} // namespace pathstr
+
+#endif // PATHBUFFER_H
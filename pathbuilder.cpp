@@ -0,0 +1,180 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathbuilder.h"
+#include "pathstr.h"
+#include <cstring>
+
+namespace pathstr {
+/*** PathBuilder ***/
+PathBuilder::PathBuilder(QStringView root)
+{
+    reset(root);
+}
+
+PathBuilder &PathBuilder::push(QStringView component)
+{
+    Mark mark { static_cast<int>(m_buffer.size()), 0 };
+
+    if (m_buffer.isEmpty()) {
+        m_buffer.append(component);
+        m_marks.push_back(mark);
+        return *this;
+    }
+
+    const bool bufferEnds = isSeparator(m_buffer.back());
+    const bool componentStarts = !component.isEmpty() && isSeparator(component.front());
+
+    if (bufferEnds && componentStarts) {
+        // joinPath() keeps the separator of the added part
+        mark.replaced = m_buffer.back().unicode();
+        m_buffer.chop(1);
+    } else if (!bufferEnds && !componentStarts) {
+        m_buffer.append(s_sep);
+    }
+
+    m_buffer.append(component);
+    m_marks.push_back(mark);
+
+    return *this;
+}
+
+PathBuilder &PathBuilder::pushFile(QStringView baseName, QStringView ext)
+{
+    push(baseName);
+
+    // joinStrings(baseName, ext, s_dot)
+    if (!ext.isEmpty()) {
+        const bool baseEnds = !baseName.isEmpty() && m_buffer.endsWith(s_dot);
+        const bool extStarts = ext.startsWith(s_dot);
+
+        if (baseEnds && extStarts)
+            m_buffer.chop(1);
+        else if (!baseEnds && !extStarts)
+            m_buffer.append(s_dot);
+
+        m_buffer.append(ext);
+    }
+
+    return *this;
+}
+
+void PathBuilder::pop()
+{
+    if (m_marks.empty())
+        return;
+
+    const Mark mark = m_marks.back();
+    m_marks.pop_back();
+
+    if (mark.replaced) {
+        m_buffer.truncate(mark.size - 1);
+        m_buffer.append(QChar(mark.replaced));
+    } else {
+        m_buffer.truncate(mark.size);
+    }
+}
+
+void PathBuilder::reset(QStringView root)
+{
+    m_buffer.truncate(0);
+    m_buffer.append(root);
+    m_marks.clear();
+}
+
+void PathBuilder::reserve(int size)
+{
+    m_buffer.reserve(size);
+}
+
+int PathBuilder::depth() const
+{
+    return m_marks.size();
+}
+
+bool PathBuilder::isEmpty() const
+{
+    return m_buffer.isEmpty();
+}
+
+QStringView PathBuilder::path() const
+{
+    return m_buffer;
+}
+
+QString PathBuilder::toString() const
+{
+    return QString(m_buffer.constData(), m_buffer.size());
+}
+
+/*** PathArena ***/
+PathArena::PathArena(int blockSize)
+    : m_blockSize(blockSize > 0 ? blockSize : 1)
+{}
+
+QStringView PathArena::store(QStringView path)
+{
+    const int size = path.size();
+
+    if (m_blocks.empty())
+        m_blocks.emplace_back(new char16_t[m_blockSize]);
+
+    if ((m_blockSize - m_used) < size) {
+        if (size > m_blockSize) {
+            // a dedicated block, inserted before the current one to keep using its free space
+            std::unique_ptr<char16_t[]> block(new char16_t[size]);
+            char16_t *data = block.get();
+            std::memcpy(data, path.utf16(), size * sizeof(char16_t));
+            m_blocks.insert(m_blocks.end() - 1, std::move(block));
+
+            ++m_count;
+            m_size += size;
+            return QStringView(data, size);
+        }
+
+        m_blocks.emplace_back(new char16_t[m_blockSize]);
+        m_used = 0;
+    }
+
+    char16_t *data = m_blocks.back().get() + m_used;
+    std::memcpy(data, path.utf16(), size * sizeof(char16_t));
+    m_used += size;
+
+    ++m_count;
+    m_size += size;
+    return QStringView(data, size);
+}
+
+void PathArena::clear()
+{
+    if (m_blocks.size() > 1) {
+        std::unique_ptr<char16_t[]> last = std::move(m_blocks.back());
+        m_blocks.clear();
+        m_blocks.push_back(std::move(last));
+    }
+
+    m_used = 0;
+    m_count = 0;
+    m_size = 0;
+}
+
+qint64 PathArena::count() const
+{
+    return m_count;
+}
+
+qint64 PathArena::size() const
+{
+    return m_size;
+}
+
+} // namespace pathstr
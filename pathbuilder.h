@@ -0,0 +1,102 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHBUILDER_H
+#define PATHBUILDER_H
+
+#include <QString>
+#include <memory>
+#include <vector>
+
+namespace pathstr {
+/* Builds paths in a single reusable buffer, for tree walks and chained joins.
+ * push() follows the joinPath() rules, pushFile() the composeFilePath() ones;
+ * pop() restores the path as it was before the last push.
+ *
+ * PathBuilder builder(u"/home");
+ * builder.push(u"folder/");                -> "/home/folder/"
+ * builder.push(u"/file.txt");              -> "/home/folder/file.txt"
+ * builder.pop();                           -> "/home/folder/"
+ * builder.pushFile(u"archive", u"tar.gz"); -> "/home/folder/archive.tar.gz"
+ */
+class PathBuilder
+{
+public:
+    PathBuilder() = default;
+    explicit PathBuilder(QStringView root);
+
+    // joinPath(path(), component); pushing to an empty builder sets the <component> as is
+    PathBuilder &push(QStringView component);
+
+    // composeFilePath(path(), baseName, ext)
+    PathBuilder &pushFile(QStringView baseName, QStringView ext);
+
+    // Removes the last pushed component
+    void pop();
+
+    // Clears the components and sets the new root, the buffer capacity is kept
+    void reset(QStringView root = QStringView());
+
+    void reserve(int size);
+
+    // The number of pushed components
+    int depth() const;
+    bool isEmpty() const;
+
+    // The view is valid until the next change of the builder
+    QStringView path() const;
+    QString toString() const;
+
+private:
+    struct Mark {
+        int size;          // the path size before the push
+        char16_t replaced; // the trailing separator replaced by the pushed one, or 0
+    };
+
+    QString m_buffer;
+    std::vector<Mark> m_marks;
+};
+
+/* Stores finished paths contiguously in large blocks, returns stable views.
+ * The views are valid until clear() or the destruction of the arena.
+ *
+ * PathArena arena;
+ * QStringView stored = arena.store(builder.path());
+ */
+class PathArena
+{
+public:
+    // <blockSize> is the size of a block in code units
+    explicit PathArena(int blockSize = 1 << 20);
+
+    QStringView store(QStringView path);
+
+    // Releases the stored paths, one block is kept for reuse
+    void clear();
+
+    // The number of stored paths
+    qint64 count() const;
+
+    // The total size of the stored paths in code units
+    qint64 size() const;
+
+private:
+    std::vector<std::unique_ptr<char16_t[]>> m_blocks;
+    int m_blockSize;
+    int m_used = 0; // in the last block
+    qint64 m_count = 0;
+    qint64 m_size = 0;
+};
+
+} // namespace pathstr
+
+#endif // PATHBUILDER_H
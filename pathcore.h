@@ -0,0 +1,901 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHCORE_H
+#define PATHCORE_H
+
+#include "simd.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+namespace pathstr {
+namespace core {
+/* The Qt-free core: the path algorithms over a string view type.
+ * std::string_view (UTF-8 bytes) and std::u16string_view are supported here,
+ * QStringView in pathinfo.h. The separators, dots and drive letters are ASCII,
+ * so UTF-8 paths are processed byte-wise, without transcoding.
+ *
+ * core::entryName(std::string_view("/folder/file.txt")) -> "file.txt"
+ * core::suffix(std::u16string_view(u"/folder/file.txt")) -> u"txt"
+ */
+
+/* The view type adaptor, a specialization provides:
+ * Char, data(), size(), mid(), null(), isLetter() and equalsNoCase()
+ */
+template <typename View>
+struct ViewTraits;
+
+template <typename CharT>
+struct ViewTraits<std::basic_string_view<CharT>>
+{
+    typedef CharT Char;
+    typedef std::basic_string_view<CharT> View;
+
+    static const Char *data(View view) { return view.data(); }
+    static int size(View view) { return static_cast<int>(view.size()); }
+    static View mid(View view, int pos, int n) { return view.substr(pos, n); }
+    static View null() { return View(); }
+
+    // ASCII letters, the drive letters only
+    static bool isLetter(Char ch) { return (ch | 0x20) >= 'a' && (ch | 0x20) <= 'z'; }
+
+    // ASCII case folding, the other characters must match exactly
+    static bool equalsNoCase(View str1, View str2)
+    {
+        if (str1.size() != str2.size())
+            return false;
+
+        for (size_t i = 0; i < str1.size(); ++i) {
+            if (str1[i] != str2[i] && !(isLetter(str1[i]) && (str1[i] | 0x20) == (str2[i] | 0x20)))
+                return false;
+        }
+
+        return true;
+    }
+};
+
+/*** Scanning ***/
+namespace detail {
+// UTF-16
+inline int scanBack(const char16_t *data, int end, char16_t sep, char16_t altSep, char16_t dot, int dots[3])
+{
+    return simd::scanBack(data, end, sep, altSep, dot, dots);
+}
+
+inline int lastIndexOf(const char16_t *data, int size, char16_t ch, char16_t altCh)
+{
+    return simd::lastIndexOf(data, size, ch, altCh);
+}
+
+inline bool startsWith(const char16_t *str, const char16_t *prefix, int size)
+{
+    return simd::mismatch(str, prefix, size) == size;
+}
+
+inline int mismatch(const char16_t *str1, const char16_t *str2, int size)
+{
+    return simd::mismatch(str1, str2, size);
+}
+
+// UTF-8 bytes
+inline int scanBack(const char *data, int end, char sep, char altSep, char dot, int dots[3])
+{
+    return simd::scanBack(data, end, sep, altSep, dot, dots);
+}
+
+inline int lastIndexOf(const char *data, int size, char ch, char altCh)
+{
+    return simd::lastIndexOf(data, size, ch, altCh);
+}
+
+inline bool startsWith(const char *str, const char *prefix, int size)
+{
+    return std::memcmp(str, prefix, size) == 0;
+}
+
+inline int mismatch(const char *str1, const char *str2, int size)
+{
+    int i = 0;
+    while (i < size && str1[i] == str2[i])
+        ++i;
+    return i;
+}
+} // namespace detail
+
+/*** Policies ***/
+/* The platform rules, fixed at compile time: the separators and the roots.
+ * The default MixedPolicy gives the results of the Qt API: "/", "C:", "C:/" and "C:\\"
+ * are roots, '\\' is a separator (isSeparator(), PathComponents), but the entry name
+ * and the parent folder are split at '/' only.
+ * PosixPolicy: '/' only, no drive roots, so the drive letter probes are compiled out.
+ * WindowsPolicy: '\\' splits the paths as '/' does, "\\" is a root as "/".
+ *
+ * core::parentFolder<PosixPolicy>(std::string_view("C:/file"))      -> "C:"
+ * core::entryName<WindowsPolicy>(std::string_view("C:\\dir\\file")) -> "file"
+ */
+struct MixedPolicy
+{
+    static constexpr bool driveRoots = true; // "C:", "C:/"
+    static constexpr char altSep = '\\';     // the second separator of isSeparator()
+    static constexpr char altNameSep = '/';  // the second one the entry name is split at
+};
+
+struct PosixPolicy
+{
+    static constexpr bool driveRoots = false;
+    static constexpr char altSep = '/';
+    static constexpr char altNameSep = '/';
+};
+
+struct WindowsPolicy
+{
+    static constexpr bool driveRoots = true;
+    static constexpr char altSep = '\\';
+    static constexpr char altNameSep = '\\';
+};
+
+/*** Checks ***/
+// '/' or the <Policy> alternative one
+template <typename Policy = MixedPolicy, typename Char>
+inline bool isSeparator(Char ch)
+{
+    return ch == '/' || ch == Policy::altSep;
+}
+
+// The separators the entry name and the parent folder are split at
+template <typename Policy = MixedPolicy, typename Char>
+inline bool isNameSeparator(Char ch)
+{
+    return ch == '/' || ch == Policy::altNameSep;
+}
+
+// "C:", "C:/folder"; always false with PosixPolicy
+template <typename Policy = MixedPolicy, typename View>
+bool hasWindowsRoot(View path)
+{
+    typedef ViewTraits<View> Traits;
+    const auto *data = Traits::data(path);
+
+    return Policy::driveRoots
+           && Traits::size(path) > 1
+           && data[1] == ':'
+           && Traits::isLetter(data[0]);
+}
+
+// "/", "C:", "C:/"
+template <typename Policy = MixedPolicy, typename View>
+bool isRoot(View path)
+{
+    typedef ViewTraits<View> Traits;
+
+    switch (Traits::size(path)) {
+    case 1:
+        return isNameSeparator<Policy>(Traits::data(path)[0]); // Linux FS root
+    case 2:
+    case 3:
+        return hasWindowsRoot<Policy>(path);                   // Windows drive root
+    default:
+        return false;
+    }
+}
+
+template <typename Policy = MixedPolicy, typename View>
+bool isAbsolute(View path)
+{
+    typedef ViewTraits<View> Traits;
+    return (Traits::size(path) > 0 && isNameSeparator<Policy>(Traits::data(path)[0])) || hasWindowsRoot<Policy>(path);
+}
+
+template <typename Policy = MixedPolicy, typename View>
+bool isRelative(View path)
+{
+    return !isAbsolute<Policy>(path);
+}
+
+/*** Parsing ***/
+/* The offsets of the path components, found in a single backward scan.
+ * All accessors are O(1) and return views into the parsed string.
+ *
+ * const PathInfo info(u"/folder/archive.tar.gz");
+ * info.entryName()      -> "archive.tar.gz"
+ * info.baseName()       -> "archive"
+ * info.completeSuffix() -> "tar.gz"
+ * info.parentFolder()   -> "/folder"
+ */
+template <typename View, typename Policy = MixedPolicy>
+struct BasicPathInfo
+{
+    typedef ViewTraits<View> Traits;
+    typedef typename Traits::Char Char;
+
+    explicit BasicPathInfo(View _path);
+
+    View path;
+    int rootSize = 0;           // "/" -> 1, "C:" -> 2, "C:/" -> 3, no root -> 0
+    int lastSep = -1;           // the separator before the entry name
+    int prevSep = -1;           // the separator before the parent folder name
+    int entryEnd = 0;           // the end of the entry name, the trailing separator excluded
+    int suffixDot = -1;         // the dot of the suffix: "archive.tar'.'gz"
+    int completeSuffixDot = -1; // the dot of the complete suffix: "archive'.'tar.gz"
+    bool trailingSep = false;   // the path ends with '/'
+    bool root = false;          // "/" or "X:[/]"
+
+    // "/folder/fooEntry/" -> "fooEntry"; root paths have no entry name
+    View entryName() const
+    {
+        return root ? Traits::null() : Traits::mid(path, lastSep + 1, entryEnd - lastSep - 1);
+    }
+
+    // "/folder/archive.tar.gz" -> "archive"
+    View baseName() const
+    {
+        return Traits::mid(entryName(), 0, ((completeSuffixDot == -1) ? entryEnd : completeSuffixDot) - lastSep - 1);
+    }
+
+    // "/folder/archive.tar.gz" -> "gz"
+    View suffix() const
+    {
+        return (suffixDot == -1) ? Traits::null() : Traits::mid(path, suffixDot + 1, entryEnd - suffixDot - 1);
+    }
+
+    // "/folder/archive.tar.gz" -> "tar.gz"
+    View completeSuffix() const
+    {
+        return (completeSuffixDot == -1) ? Traits::null()
+                                         : Traits::mid(path, completeSuffixDot + 1, entryEnd - completeSuffixDot - 1);
+    }
+
+    int suffixSize() const { return Traits::size(suffix()); }
+    int completeSuffixSize() const { return Traits::size(completeSuffix()); }
+
+    // "/folder/file_or_folder2/" -> "/folder"
+    View parentFolder() const
+    {
+        switch (lastSep) {
+        case -1: // root --> root; string'/' --> ""
+            return root ? path : Traits::null();
+        case 0: // /folder'/' --> "/"
+            return Traits::mid(path, 0, 1);
+        case 2: // C:/folder'/' --> "C:/"
+            return Traits::mid(path, 0, (rootSize > 1) ? 3 : 2);
+        default: // /folder/item'/' --> /folder
+            return Traits::mid(path, 0, lastSep);
+        }
+    }
+
+    // The name of the parent folder: "/home/folder/file" -> "folder"
+    View parentName() const
+    {
+        return (lastSep < 1 || lastSep < rootSize) ? Traits::null() : Traits::mid(path, prevSep + 1, lastSep - prevSep - 1);
+    }
+
+    // "C:/folder" -> "C:/", the root is kept as is
+    View rootPath() const { return Traits::mid(path, 0, rootSize); }
+
+    bool isRoot() const { return root; }
+    bool isAbsolute() const { return rootSize > 0; }
+    bool isRelative() const { return rootSize == 0; }
+    bool hasWindowsRoot() const { return rootSize > 1; }
+};
+
+template <typename View, typename Policy>
+BasicPathInfo<View, Policy>::BasicPathInfo(View _path)
+    : path(_path)
+{
+    const Char *data = Traits::data(path);
+    const int size = Traits::size(path);
+
+    // root: "/", "C:" or "C:/"
+    if (size > 0 && isNameSeparator<Policy>(data[0]))
+        rootSize = 1;
+    else if (core::hasWindowsRoot<Policy>(path))
+        rootSize = (size > 2 && isSeparator<Policy>(data[2])) ? 3 : 2;
+
+    root = (size == 1) ? (rootSize == 1) : (size < 4 && rootSize > 1);
+    trailingSep = (size > 0 && isNameSeparator<Policy>(data[size - 1]));
+    entryEnd = trailingSep ? size - 1 : size;
+
+    if (root) {
+        entryEnd = 0;
+        return;
+    }
+
+    // the last three dots of the entry name, from the end
+    int dots[3];
+    lastSep = detail::scanBack(data, entryEnd, Char('/'), Char(Policy::altNameSep), Char('.'), dots);
+
+    // suffix: the last dot, if it's not the first character of the entry name
+    if (dots[0] > lastSep + 1)
+        suffixDot = dots[0];
+
+    // complete suffix: the last two dots, the last character of the entry name doesn't count
+    const int *csufDots = (dots[0] == entryEnd - 1) ? dots + 1 : dots;
+
+    if (csufDots[1] > lastSep + 1)
+        completeSuffixDot = csufDots[1];
+    else if (csufDots[0] > lastSep + 1)
+        completeSuffixDot = csufDots[0];
+
+    // the separator before the parent folder name
+    if (lastSep > 0)
+        prevSep = detail::lastIndexOf(data, lastSep, Char('/'), Char(Policy::altNameSep));
+}
+
+/*** Accessors ***/
+// "/folder/file.txt" -> "file.txt"; root paths have no entry name
+template <typename Policy = MixedPolicy, typename View>
+View entryName(View path)
+{
+    return BasicPathInfo<View, Policy>(path).entryName();
+}
+
+// "/folder/archive.tar.gz" -> "archive"
+template <typename Policy = MixedPolicy, typename View>
+View baseName(View fileName)
+{
+    return BasicPathInfo<View, Policy>(fileName).baseName();
+}
+
+// "/folder/folder2/" -> "/folder"
+template <typename Policy = MixedPolicy, typename View>
+View parentFolder(View path)
+{
+    return BasicPathInfo<View, Policy>(path).parentFolder();
+}
+
+// "/folder/file.txt" -> "txt", the case is kept
+template <typename Policy = MixedPolicy, typename View>
+View suffix(View fileName)
+{
+    return BasicPathInfo<View, Policy>(fileName).suffix();
+}
+
+// "/folder/archive.tar.gz" -> "tar.gz", the case is kept
+template <typename Policy = MixedPolicy, typename View>
+View completeSuffix(View fileName)
+{
+    return BasicPathInfo<View, Policy>(fileName).completeSuffix();
+}
+
+// ("/rootFolder", "/rootFolder/folder2/file") -> "folder2/file"; not in the <rootFolder> -> null
+template <typename Policy = MixedPolicy, typename View>
+View relativePath(View rootFolder, View fullPath)
+{
+    typedef ViewTraits<View> Traits;
+    const int rootSize = Traits::size(rootFolder);
+    const int fullSize = Traits::size(fullPath);
+
+    if (rootSize == 0)
+        return fullPath;
+
+    if (fullSize < rootSize || !detail::startsWith(Traits::data(fullPath), Traits::data(rootFolder), rootSize))
+        return Traits::null();
+
+    const int cut = isNameSeparator<Policy>(Traits::data(rootFolder)[rootSize - 1]) ? rootSize - 1 : rootSize;
+
+    return ((cut < fullSize) && isNameSeparator<Policy>(Traits::data(fullPath)[cut])) ? Traits::mid(fullPath, cut + 1, fullSize - cut - 1)
+                                                                       : Traits::null();
+
+    // #2 impl. --> x2 slower due to (rootFolder + '/')
+    // const QString &_root = rootFolder.endsWith('/') ? rootFolder : rootFolder + '/';
+    // return fullPath.startsWith(_root) ? fullPath.mid(_root.size()) : QString();
+}
+
+// "/folder" -> "/", "C:/folder" -> "C:/", "C:" -> "C:", no root -> null
+template <typename Policy = MixedPolicy, typename View>
+View root(View path)
+{
+    typedef ViewTraits<View> Traits;
+    const int size = Traits::size(path);
+
+    // Unix-style fs root "/"
+    if (size > 0 && isNameSeparator<Policy>(Traits::data(path)[0]))
+        return Traits::mid(path, 0, 1);
+
+    // Windows-style root "C:" or "C:/"
+    if (hasWindowsRoot<Policy>(path))
+        return Traits::mid(path, 0, (size > 2 && isSeparator<Policy>(Traits::data(path)[2])) ? 3 : 2);
+
+    // no root found
+    return Traits::null();
+}
+
+namespace detail {
+// "/" and "\\" are the same root with WindowsPolicy, so are "c:/" and "C:\\"; "C:" differs from "C:/"
+template <typename Policy, typename View>
+bool sameRoot(View root1, View root2)
+{
+    typedef ViewTraits<View> Traits;
+    const int size = Traits::size(root1);
+
+    if (size != Traits::size(root2))
+        return false;
+
+    // "/" vs "\\": both are separators; "C:/": the drive letters decide
+    return size < 2 || Traits::equalsNoCase(Traits::mid(root1, 0, 1), Traits::mid(root2, 0, 1));
+}
+
+// The size of the common ancestor in the <path1>, -1 if there is none
+template <typename Policy, typename View>
+int commonAncestorSize(View path1, View path2)
+{
+    typedef ViewTraits<View> Traits;
+    const int rootSize = Traits::size(root<Policy>(path1));
+
+    if (!sameRoot<Policy>(Traits::mid(path1, 0, rootSize), root<Policy>(path2)))
+        return -1;
+
+    const auto *data1 = Traits::data(path1);
+    const auto *data2 = Traits::data(path2);
+    const int size1 = Traits::size(path1);
+    const int size2 = Traits::size(path2);
+
+    // the first difference; "/" and "\\" are the same separator, a run of them is one: "/a//b", "/a/b"
+    int pos1 = rootSize;
+    int pos2 = rootSize;
+    for (;;) {
+        const int same = mismatch(data1 + pos1, data2 + pos2, std::min(size1 - pos1, size2 - pos2));
+        pos1 += same;
+        pos2 += same;
+
+        const bool sep1 = pos1 < size1 && isSeparator<Policy>(data1[pos1]);
+        const bool sep2 = pos2 < size2 && isSeparator<Policy>(data2[pos2]);
+        const bool inRun = pos1 > 0 && pos2 > 0
+                           && isSeparator<Policy>(data1[pos1 - 1]) && isSeparator<Policy>(data2[pos2 - 1]);
+
+        if (!(sep1 && sep2) && !((sep1 || sep2) && inRun))
+            break;
+
+        while (pos1 < size1 && isSeparator<Policy>(data1[pos1]))
+            ++pos1;
+        while (pos2 < size2 && isSeparator<Policy>(data2[pos2]))
+            ++pos2;
+    }
+
+    // the shorter path is the ancestor: ("/folder", "/folder/file"); otherwise the last separator before the difference
+    int end = pos1;
+    if (!((pos1 == size1 && (pos2 == size2 || isSeparator<Policy>(data2[pos2])))
+          || (pos2 == size2 && isSeparator<Policy>(data1[pos1])))) {
+        end = lastIndexOf(data1 + rootSize, pos1 - rootSize, '/', Policy::altSep) + rootSize;
+        end = std::max(end, rootSize);
+    }
+
+    // the trailing separators are dropped, the root is kept as is
+    while (end > rootSize && isSeparator<Policy>(data1[end - 1]))
+        --end;
+
+    return end > 0 ? end : -1;
+}
+} // namespace detail
+
+/* ("/folder/folder2/file", "/folder/file2") -> "/folder", a view into the <path1>
+ * A path is its own ancestor: ("/folder/", "/folder/file") -> "/folder", the trailing
+ * separator is dropped as by parentFolder(). ("/file", "/file2") -> "/", the root is kept
+ * as is: ("c:\\folder", "C:/folder2") -> "c:\\". A run of separators is one: ("/a//b", "/a/b") -> "/a//b".
+ * The roots differ or nothing is shared -> null
+ */
+template <typename Policy = MixedPolicy, typename View>
+View commonAncestor(View path1, View path2)
+{
+    typedef ViewTraits<View> Traits;
+    const int size = detail::commonAncestorSize<Policy>(path1, path2);
+
+    return (size < 0) ? Traits::null() : Traits::mid(path1, 0, size);
+}
+
+/* ("file.txt", "txt") -> true; (".TXT") -> true; ("cpp") -> false
+ * An empty <ext> matches the names without a suffix.
+ */
+template <typename Policy = MixedPolicy, typename View>
+bool hasExtension(View fileName, View ext)
+{
+    typedef ViewTraits<View> Traits;
+    const int fileSize = Traits::size(fileName);
+    const int extSize = Traits::size(ext);
+
+    if (extSize == 0)
+        return BasicPathInfo<View, Policy>(fileName).suffixSize() == 0;
+
+    // ".ext"
+    int dotInd = fileSize - extSize;
+
+    // "ext"
+    if (Traits::data(ext)[0] != '.')
+        --dotInd;
+
+    return ((dotInd > 0 && Traits::data(fileName)[dotInd] == '.')
+            && Traits::equalsNoCase(Traits::mid(fileName, fileSize - extSize, extSize), ext));
+}
+
+
+/*** Components ***/
+/* The root and the names of a path, as views into it. The components are found lazily
+ * while iterating, in both directions; nothing is allocated. The names are separated as
+ * by isSeparator(), the empty ones ("//", the trailing separator) are skipped. The root
+ * is the first component, kept as is (see root()): "/", "C:/", "C:".
+ *
+ * for (QStringView name : PathComponents(u"C:\\folder//file.txt/")) -> "C:\\", "folder", "file.txt"
+ *
+ * The path() of an iterator is the prefix of the path up to its component, the ancestor:
+ * for (auto it = comps.rbegin(); it != comps.rend(); ++it) -> it.path(): "/home/user", "/home", "/"
+ * The iterators hold the path view, they don't refer to the range object.
+ */
+template <typename View, typename Policy = MixedPolicy>
+class BasicPathComponents
+{
+public:
+    typedef ViewTraits<View> Traits;
+    typedef typename Traits::Char Char;
+
+    template <bool Reverse>
+    class Iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef View value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const View *pointer;
+        typedef View reference;
+
+        Iterator() = default;
+
+        // The component
+        View operator*() const { return Traits::mid(m_path, m_begin, m_end - m_begin); }
+
+        // The path up to the end of the component: "/home/user/file" -> "/", "/home", "/home/user"...
+        View path() const { return Traits::mid(m_path, 0, m_end); }
+
+        // The root component, "/" or "C:/", is not a name
+        bool isRoot() const { return m_begin == 0 && m_end == m_rootSize; }
+
+        Iterator &operator++()
+        {
+            Reverse ? previous(m_path, m_rootSize, m_begin, m_end) : next(m_path, m_rootSize, m_begin, m_end);
+            return *this;
+        }
+
+        Iterator &operator--()
+        {
+            Reverse ? next(m_path, m_rootSize, m_begin, m_end) : previous(m_path, m_rootSize, m_begin, m_end);
+            return *this;
+        }
+
+        Iterator operator++(int) { Iterator it = *this; ++*this; return it; }
+        Iterator operator--(int) { Iterator it = *this; --*this; return it; }
+
+        bool operator==(const Iterator &other) const { return m_begin == other.m_begin; }
+        bool operator!=(const Iterator &other) const { return m_begin != other.m_begin; }
+
+    private:
+        friend class BasicPathComponents;
+
+        Iterator(View path, int rootSize, int begin, int end)
+            : m_path(path), m_rootSize(rootSize), m_begin(begin), m_end(end)
+        {}
+
+        View m_path;
+        int m_rootSize = 0;
+        int m_begin = 0; // the path size past the last component, -1 before the first one
+        int m_end = 0;
+    };
+
+    typedef Iterator<false> const_iterator;
+    typedef Iterator<true> const_reverse_iterator;
+
+    explicit BasicPathComponents(View path)
+        : m_path(path)
+        , m_rootSize(Traits::size(core::root<Policy>(path)))
+    {}
+
+    const_iterator begin() const
+    {
+        int begin = -1, end = -1;
+        next(m_path, m_rootSize, begin, end);
+        return const_iterator(m_path, m_rootSize, begin, end);
+    }
+
+    const_iterator end() const
+    {
+        const int size = Traits::size(m_path);
+        return const_iterator(m_path, m_rootSize, size, size);
+    }
+
+    const_reverse_iterator rbegin() const
+    {
+        int begin = Traits::size(m_path), end = begin;
+        previous(m_path, m_rootSize, begin, end);
+        return const_reverse_iterator(m_path, m_rootSize, begin, end);
+    }
+
+    const_reverse_iterator rend() const { return const_reverse_iterator(m_path, m_rootSize, -1, -1); }
+
+    // The number of components, the root included
+    int count() const
+    {
+        int count = 0;
+        for (const_iterator it = begin(); it != end(); ++it)
+            ++count;
+        return count;
+    }
+
+    bool isEmpty() const { return begin() == end(); }
+
+    // The root as is: "C:\\folder" -> "C:\\"; no root -> null
+    View root() const { return core::root<Policy>(m_path); }
+
+    // The last component: "/folder/file/" -> "file", "/" -> "/"; no components -> null
+    View last() const { return isEmpty() ? Traits::null() : *rbegin(); }
+
+    // The path up to the end of the component <index>: ("/home/user/file", 1) -> "/home"; out of range -> null
+    View ancestor(int index) const
+    {
+        if (index < 0)
+            return Traits::null();
+
+        const_iterator it = begin();
+        for (; index > 0 && it != end(); --index)
+            ++it;
+
+        return (it == end()) ? Traits::null() : it.path();
+    }
+
+    View path() const { return m_path; }
+
+private:
+    // [begin, end) <-- the next component; [size, size) after the last one
+    static void next(View path, int rootSize, int &begin, int &end)
+    {
+        const Char *data = Traits::data(path);
+        const int size = Traits::size(path);
+
+        if (begin == -1 && rootSize > 0) {
+            begin = 0;
+            end = rootSize;
+            return;
+        }
+
+        begin = std::max(end, rootSize);
+        while (begin < size && isSeparator<Policy>(data[begin]))
+            ++begin;
+
+        end = begin;
+        while (end < size && !isSeparator<Policy>(data[end]))
+            ++end;
+    }
+
+    // [begin, end) <-- the previous component; [-1, -1) before the first one
+    static void previous(View path, int rootSize, int &begin, int &end)
+    {
+        const Char *data = Traits::data(path);
+
+        end = begin;
+        while (end > rootSize && isSeparator<Policy>(data[end - 1]))
+            --end;
+
+        // only the root is left, if it's not the current one
+        if (end <= rootSize) {
+            const bool toRoot = (begin > 0 && rootSize > 0);
+            begin = toRoot ? 0 : -1;
+            end = toRoot ? rootSize : -1;
+            return;
+        }
+
+        begin = end;
+        while (begin > rootSize && !isSeparator<Policy>(data[begin - 1]))
+            --begin;
+    }
+
+    View m_path;
+    int m_rootSize;
+};
+
+/*** Ordering ***/
+/* Compares the paths code unit by code unit, but '/' sorts before any other character,
+ * so the contents of a folder follow it without other entries in between:
+ * "/a" < "/a/z" < "/a-b" < "/ab"
+ */
+template <typename View>
+int comparePaths(View path1, View path2)
+{
+    typedef ViewTraits<View> Traits;
+    typedef typename std::make_unsigned<typename Traits::Char>::type Unit;
+    const int size1 = Traits::size(path1);
+    const int size2 = Traits::size(path2);
+    const int size = std::min(size1, size2);
+    const int pos = detail::mismatch(Traits::data(path1), Traits::data(path2), size);
+
+    // one is the start of the other: the shorter one first
+    if (pos == size)
+        return (size1 > size) - (size2 > size);
+
+    auto rank = [](Unit ch) -> unsigned { return (ch == '/') ? 0 : unsigned(ch) + 1; };
+    return (rank(Unit(Traits::data(path1)[pos])) < rank(Unit(Traits::data(path2)[pos]))) ? -1 : 1;
+}
+
+/*** Snapshot diff ***/
+enum class DiffKind { Added, Removed, RemovedFolder };
+
+namespace detail {
+// true if the <path> is in the <folder>: "/folder/file", "/folder" -> true
+template <typename View>
+bool isInside(View path, View folder)
+{
+    typedef ViewTraits<View> Traits;
+    const int folderSize = Traits::size(folder);
+
+    if (Traits::size(path) <= folderSize || !startsWith(Traits::data(path), Traits::data(folder), folderSize))
+        return false;
+
+    // the root ends with '/'
+    return Traits::data(folder)[folderSize - 1] == '/' || Traits::data(path)[folderSize] == '/';
+}
+
+/* The position in the <path> of the '/' ending its deepest parent folder shared with the <other> path,
+ * -1 if there is none; the <path> size if the <other> path is inside the <path>.
+ */
+template <typename View>
+int sharedFolderEnd(View path, View other)
+{
+    typedef ViewTraits<View> Traits;
+    const int size = Traits::size(path);
+    const int otherSize = Traits::size(other);
+    const auto *data = Traits::data(path);
+    const int pos = mismatch(data, Traits::data(other), std::min(size, otherSize));
+
+    if (pos == size && otherSize > size && Traits::data(other)[pos] == '/')
+        return size;
+
+    if (pos == otherSize && size > otherSize && data[pos] == '/')
+        return pos;
+
+    return lastIndexOf(data, pos, typename Traits::Char('/'), typename Traits::Char('/'));
+}
+
+/* The size of the topmost parent folder of the removed <path> with no current paths in it,
+ * 0 if the parent folder of the <path> has some. <before> and <after> are the current paths
+ * around the <path> in the comparePaths() order: any current path in a folder of the <path>
+ * would be next to it.
+ */
+template <typename View>
+int removedFolderSize(View path, View before, bool hasBefore, View after, bool hasAfter)
+{
+    typedef ViewTraits<View> Traits;
+    const int size = Traits::size(path);
+    const auto *data = Traits::data(path);
+
+    int shared = -1;
+    if (hasBefore)
+        shared = sharedFolderEnd(path, before);
+    if (hasAfter)
+        shared = std::max(shared, sharedFolderEnd(path, after));
+
+    // the folder below the shared one
+    int end = shared + 1;
+    while (end < size && data[end] != '/')
+        ++end;
+
+    if (end >= size)
+        return 0;
+
+    // "/", "C:/"
+    const int rootSize = Traits::size(root(path));
+    return (end < rootSize) ? rootSize : end;
+}
+} // namespace detail
+
+/* Merges two snapshots sorted in the comparePaths() order, calls <sink(kind, path)> in that order.
+ * <nextPrevious(path)> and <nextCurrent(path)> set the next path of each snapshot, false at the end.
+ * Instead of all the removed paths of a folder which has nothing left in the current snapshot,
+ * the topmost such folder is passed once as a RemovedFolder (parentFolder() rules).
+ * The repeated paths are skipped.
+ *
+ * A <sink(kind, path, position)> also gets the position of the path in its source: the number
+ * of the paths taken before it from the <nextCurrent> (Added) or the <nextPrevious> (Removed;
+ * RemovedFolder: the first removed path in the folder).
+ *
+ * When the snapshots are merged in parts, <currentBefore> and <currentAfter> are the current
+ * paths around the merged range (if <hasBefore> and <hasAfter>).
+ */
+template <typename View, typename Source1, typename Source2, typename Sink>
+void diffSorted(Source1 &&nextPrevious, Source2 &&nextCurrent, Sink &&sink,
+                View currentBefore = View(), bool hasBefore = false,
+                View currentAfter = View(), bool hasAfter = false)
+{
+    View prev, cur;
+    bool hasPrev = nextPrevious(prev);
+    bool hasCur = nextCurrent(cur);
+    int prevPos = 0;        // the positions of the <prev> and the <cur> in their sources
+    int curPos = 0;
+
+    View lastCur = currentBefore;
+    bool hasLastCur = hasBefore;
+
+    View folder;            // the last removed folder
+    bool hasFolder = false;
+    View removed;           // the removed path is held back: it's dropped if it's the next removed folder
+    int removedPos = 0;
+    bool hasRemoved = false;
+
+    auto report = [&](DiffKind kind, View path, int pos) {
+        if constexpr (std::is_invocable_v<Sink &, DiffKind, View, int>)
+            sink(kind, path, pos);
+        else
+            sink(kind, path);
+    };
+
+    auto skipRepeated = [](auto &&next, View &path, bool &has, int &pos) {
+        const View last = path;
+        do {
+            has = next(path);
+            ++pos;
+        } while (has && comparePaths(path, last) == 0);
+    };
+
+    auto flushRemoved = [&]() {
+        if (hasRemoved)
+            report(DiffKind::Removed, removed, removedPos);
+        hasRemoved = false;
+    };
+
+    while (hasPrev || hasCur) {
+        const int cmp = !hasPrev ? 1 : (!hasCur ? -1 : comparePaths(prev, cur));
+
+        if (cmp >= 0) {
+            if (cmp > 0) {
+                flushRemoved();
+                report(DiffKind::Added, cur, curPos);
+            } else if (cmp == 0) {
+                skipRepeated(nextPrevious, prev, hasPrev, prevPos);
+            }
+
+            lastCur = cur;
+            hasLastCur = true;
+            skipRepeated(nextCurrent, cur, hasCur, curPos);
+            continue;
+        }
+
+        // removed
+        if (!hasFolder || !detail::isInside(prev, folder)) {
+            const int size = detail::removedFolderSize(prev, lastCur, hasLastCur, hasCur ? cur : currentAfter,
+                                                       hasCur || hasAfter);
+            if (size > 0) {
+                folder = ViewTraits<View>::mid(prev, 0, size);
+                hasFolder = true;
+
+                // the folder itself is in the snapshot
+                if (hasRemoved && comparePaths(removed, folder) == 0)
+                    hasRemoved = false;
+
+                flushRemoved();
+                report(DiffKind::RemovedFolder, folder, prevPos);
+            } else {
+                flushRemoved();
+                removed = prev;
+                removedPos = prevPos;
+                hasRemoved = true;
+            }
+        }
+
+        skipRepeated(nextPrevious, prev, hasPrev, prevPos);
+    }
+
+    flushRemoved();
+}
+
+} // namespace core
+} // namespace pathstr
+
+#endif // PATHCORE_H
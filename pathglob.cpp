@@ -0,0 +1,281 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathglob.h"
+#include "pathstr_p.h"
+
+namespace pathstr {
+/* The next name from the <pos>: an empty one for the leading separator (the root),
+ * then the non-empty runs between the separators. False if there is none.
+ */
+static bool nextName(QStringView path, int &pos, QStringView &name)
+{
+    if (pos == 0 && !path.isEmpty() && isSeparator(path.at(0))) {
+        name = path.left(0);
+        pos = 1;
+        return true;
+    }
+
+    while (pos < path.size() && isSeparator(path.at(pos)))
+        ++pos;
+
+    if (pos == path.size())
+        return false;
+
+    const int start = pos;
+    while (pos < path.size() && !isSeparator(path.at(pos)))
+        ++pos;
+
+    name = path.mid(start, pos - start);
+    return true;
+}
+
+PathGlob::PathGlob(const QString &pattern, Qt::CaseSensitivity cs)
+    : m_pattern(pattern)
+    , m_cs(cs)
+{
+    int pos = 0;
+    QStringView name;
+
+    while (nextName(pattern, pos, name))
+        compileSegment(name);
+
+    m_absolute = !m_segments.empty() && !m_segments.front().globStar
+                 && m_segments.front().begin == m_segments.front().end;
+
+    // the literal tokens at the start of the first name and at the end of the last one
+    if (!m_segments.empty() && !m_segments.front().globStar) {
+        const Segment &first = m_segments.front();
+        for (int i = first.begin; i < first.end && m_tokens[i].type == Literal; ++i)
+            m_prefix.append(QChar(m_tokens[i].ch));
+    }
+
+    if (!m_segments.empty() && !m_segments.back().globStar) {
+        const Segment &last = m_segments.back();
+        int i = last.end;
+        while (i > last.begin && m_tokens[i - 1].type == Literal)
+            --i;
+
+        // the whole name is literal: the prefix is the same
+        if (i > last.begin || m_segments.size() > 1) {
+            for (; i < last.end; ++i)
+                m_suffix.append(QChar(m_tokens[i].ch));
+        }
+    }
+}
+
+void PathGlob::compileSegment(QStringView segment)
+{
+    if (segment == u"**") {
+        // "**/**" is the same as "**"
+        if (m_segments.empty() || !m_segments.back().globStar)
+            m_segments.push_back({ 0, 0, true });
+        return;
+    }
+
+    const int begin = static_cast<int>(m_tokens.size());
+
+    for (int i = 0; i < segment.size(); ++i) {
+        const QChar ch = segment.at(i);
+
+        if (ch == u'*') {
+            // "a**b" is the same as "a*b"
+            if (static_cast<int>(m_tokens.size()) == begin || m_tokens.back().type != Star)
+                m_tokens.push_back({ Star, false, 0, 0, 0 });
+            continue;
+        }
+
+        if (ch == u'?') {
+            m_tokens.push_back({ AnyChar, false, 0, 0, 0 });
+            continue;
+        }
+
+        if (ch == u'[') {
+            // the first ']' is a literal one: "[]a]"
+            int j = i + 1;
+            const bool negated = j < segment.size() && (segment.at(j) == u'!' || segment.at(j) == u'^');
+            if (negated)
+                ++j;
+
+            int close = segment.indexOf(u']', j < segment.size() ? j + 1 : j);
+
+            if (close != -1) {
+                const int rangeBegin = static_cast<int>(m_ranges.size());
+
+                for (; j < close; ++j) {
+                    const char16_t first = segment.at(j).unicode();
+
+                    if (j + 2 < close && segment.at(j + 1) == u'-') {
+                        m_ranges.push_back({ first, segment.at(j + 2).unicode() });
+                        j += 2;
+                    } else {
+                        m_ranges.push_back({ first, first });
+                    }
+                }
+
+                m_tokens.push_back({ Class, negated, 0, rangeBegin, static_cast<int>(m_ranges.size()) });
+                i = close;
+                continue;
+            }
+            // no closing bracket: a literal '['
+        }
+
+        const char16_t lit = (m_cs == Qt::CaseSensitive) ? ch.unicode() : foldCase(ch.unicode());
+        m_tokens.push_back({ Literal, false, lit, 0, 0 });
+    }
+
+    m_segments.push_back({ begin, static_cast<int>(m_tokens.size()), false });
+}
+
+bool PathGlob::matches(QStringView path) const
+{
+    // the early rejects
+    if (m_absolute && (path.isEmpty() || !isSeparator(path.at(0))))
+        return false;
+
+    if (!m_prefix.isEmpty() && !matchLiteral(path.left(m_prefix.size()), m_prefix))
+        return false;
+
+    if (!m_suffix.isEmpty()) {
+        int end = path.size();
+        while (end > 0 && isSeparator(path.at(end - 1)))
+            --end;
+
+        if (end < m_suffix.size() || !matchLiteral(path.mid(end - m_suffix.size(), m_suffix.size()), m_suffix))
+            return false;
+    }
+
+    // "**" takes any number of names: on a mismatch, the last one takes one more name
+    const int segCount = static_cast<int>(m_segments.size());
+    int seg = 0;
+    int pos = 0;
+    int starSeg = -1;
+    int starPos = 0;
+    QStringView name;
+
+    for (int next = pos; nextName(path, next, name); next = pos) {
+        if (seg < segCount && m_segments[seg].globStar) {
+            starSeg = ++seg;
+            starPos = pos;
+        } else if (seg < segCount && matchSegment(m_segments[seg], name)) {
+            ++seg;
+            pos = next;
+        } else if (starSeg != -1) {
+            seg = starSeg;
+            nextName(path, starPos, name);
+            pos = starPos;
+        } else {
+            return false;
+        }
+    }
+
+    while (seg < segCount && m_segments[seg].globStar)
+        ++seg;
+
+    return seg == segCount;
+}
+
+bool PathGlob::matchSegment(const Segment &segment, QStringView name) const
+{
+    // the root matches the leading separator only
+    if (name.isEmpty())
+        return segment.begin == segment.end;
+
+    // '*' takes no characters first, on a mismatch the last one takes one more
+    int t = 0;
+    int tok = segment.begin;
+    int starTok = -1;
+    int starT = 0;
+
+    while (t < name.size()) {
+        if (tok < segment.end && m_tokens[tok].type == Star) {
+            starTok = ++tok;
+            starT = t;
+        } else if (tok < segment.end && matchChar(m_tokens[tok], name.at(t))) {
+            ++tok;
+            ++t;
+        } else if (starTok != -1) {
+            tok = starTok;
+            t = ++starT;
+        } else {
+            return false;
+        }
+    }
+
+    while (tok < segment.end && m_tokens[tok].type == Star)
+        ++tok;
+
+    return tok == segment.end;
+}
+
+bool PathGlob::matchChar(const Token &token, QChar ch) const
+{
+    switch (token.type) {
+    case Literal:
+        return token.ch == ((m_cs == Qt::CaseSensitive) ? ch.unicode() : foldCase(ch.unicode()));
+    case Class:
+        return inClass(token, ch.unicode()) != token.negated;
+    default: // AnyChar
+        return true;
+    }
+}
+
+bool PathGlob::inClass(const Token &token, char16_t ch) const
+{
+    auto inRanges = [&](char16_t c) {
+        for (int i = token.rangeBegin; i < token.rangeEnd; ++i) {
+            if (c >= m_ranges[i].first && c <= m_ranges[i].last)
+                return true;
+        }
+        return false;
+    };
+
+    if (inRanges(ch))
+        return true;
+
+    if (m_cs == Qt::CaseSensitive)
+        return false;
+
+    const QChar qch(ch);
+    return inRanges(qch.toLower().unicode()) || inRanges(qch.toUpper().unicode());
+}
+
+bool PathGlob::matchLiteral(QStringView text, const QString &literal) const
+{
+    if (text.size() != literal.size())
+        return false;
+
+    for (int i = 0; i < text.size(); ++i) {
+        const char16_t ch = text.at(i).unicode();
+        if (literal.at(i).unicode() != ((m_cs == Qt::CaseSensitive) ? ch : foldCase(ch)))
+            return false;
+    }
+
+    return true;
+}
+
+QString PathGlob::pattern() const
+{
+    return m_pattern;
+}
+
+Qt::CaseSensitivity PathGlob::caseSensitivity() const
+{
+    return m_cs;
+}
+
+bool PathGlob::isEmpty() const
+{
+    return m_segments.empty();
+}
+
+} // namespace pathstr
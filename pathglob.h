@@ -0,0 +1,90 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHGLOB_H
+#define PATHGLOB_H
+
+#include "pathstr.h"
+#include <vector>
+
+namespace pathstr {
+// A wildcard pattern, compiled once for matching many paths.
+// The pattern is matched against the whole path, folder by folder:
+//   *       any characters within a folder or file name
+//   ?       a single character
+//   [a-z]   a character from the class, [!a-z] or [^a-z]: not from the class
+//   **      as a whole name, any number of folders (none too)
+// A '/' or '\\' in the pattern matches any separator ('/', '\\'), duplicate and trailing
+// separators are ignored in both. A special character is matched literally within a class: "[*]".
+//
+// const PathGlob glob("**/build/*.o");
+// glob.matches(u"/home/project/build/main.o")  -> true
+// glob.matches(u"/home/project/src/main.o")    -> false
+// PathGlob("src/**/test_*.cpp").matches(u"src/core/test_path.cpp") -> true
+//
+// The literal start and end of the pattern are checked first, most paths are rejected by them.
+// Matching allocates nothing and takes O(path size * pattern size) at most.
+class PathGlob
+{
+public:
+    PathGlob() = default;
+    explicit PathGlob(const QString &pattern, Qt::CaseSensitivity cs = Qt::CaseSensitive);
+
+    bool matches(QStringView path) const;
+
+    QString pattern() const;
+    Qt::CaseSensitivity caseSensitivity() const;
+    bool isEmpty() const;
+
+private:
+    enum TokenType : quint8 { Literal, AnyChar, Star, Class };
+
+    struct Token {
+        TokenType type;
+        bool negated;   // Class
+        char16_t ch;    // Literal, case-folded if insensitive
+        int rangeBegin; // Class: [rangeBegin, rangeEnd) in m_ranges
+        int rangeEnd;
+    };
+
+    struct Segment {
+        int begin;     // [begin, end) in m_tokens
+        int end;
+        bool globStar; // "**"
+    };
+
+    struct Range {
+        char16_t first;
+        char16_t last;
+    };
+
+    void compileSegment(QStringView segment);
+    bool matchSegment(const Segment &segment, QStringView name) const;
+    bool matchChar(const Token &token, QChar ch) const;
+    bool inClass(const Token &token, char16_t ch) const;
+    bool matchLiteral(QStringView text, const QString &literal) const;
+
+    QString m_pattern;
+    Qt::CaseSensitivity m_cs = Qt::CaseSensitive;
+    std::vector<Token> m_tokens;
+    std::vector<Segment> m_segments;
+    std::vector<Range> m_ranges;
+
+    // the early checks
+    QString m_prefix;      // the literal start of the first name
+    QString m_suffix;      // the literal end of the last name
+    bool m_absolute = false;
+};
+
+} // namespace pathstr
+
+#endif // PATHGLOB_H
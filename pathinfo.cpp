@@ -0,0 +1,20 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathinfo.h"
+
+namespace pathstr {
+namespace core {
+// the Qt API parses every path with it, instantiated once
+template struct BasicPathInfo<QStringView>;
+} // namespace core
+} // namespace pathstr
@@ -0,0 +1,62 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHINFO_H
+#define PATHINFO_H
+
+#include "pathcore.h"
+#include <QStringView>
+
+namespace pathstr {
+namespace core {
+// QStringView: the Qt character classes and case folding
+template <>
+struct ViewTraits<QStringView>
+{
+    typedef char16_t Char;
+    typedef QStringView View;
+
+    static const Char *data(View view) { return view.utf16(); }
+    static int size(View view) { return static_cast<int>(view.size()); }
+    static View mid(View view, int pos, int n) { return view.mid(pos, n); }
+    static View null() { return View(); }
+    static bool isLetter(Char ch) { return QChar(ch).isLetter(); }
+
+    // ASCII fast path, the Unicode case folding decides for the rest
+    static bool equalsNoCase(View str1, View str2)
+    {
+        const int ascii = (str1.size() == str2.size()) ? simd::equalsAsciiNoCase(str1.utf16(), str2.utf16(), size(str1)) : -1;
+        return (ascii == -1) ? (str1.compare(str2, Qt::CaseInsensitive) == 0) : (ascii == 1);
+    }
+};
+
+extern template struct BasicPathInfo<QStringView>;
+} // namespace core
+
+/* The offsets of the path components, the results are the same as those of the pathstr functions.
+ *
+ * const PathInfo info(u"/folder/archive.tar.gz");
+ * info.baseName()     -> "archive"
+ * info.parentFolder() -> "/folder"
+ */
+typedef core::BasicPathInfo<QStringView> PathInfo;
+
+/* The root and the names of a path, lazily, as views into it.
+ *
+ * for (QStringView name : PathComponents(u"/home/user//file.txt")) -> "/", "home", "user", "file.txt"
+ * PathComponents(u"/home/user/file.txt").ancestor(2)              -> "/home/user"
+ */
+typedef core::BasicPathComponents<QStringView> PathComponents;
+
+} // namespace pathstr
+
+#endif // PATHINFO_H
@@ -0,0 +1,399 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathkey.h"
+#include "casefold_p.h"
+#include <algorithm>
+#include <cstring>
+
+namespace pathstr {
+static const quint64 s_seed = 0x243F6A8885A308D3ull;
+static const quint64 s_mulWord = 0x9E3779B97F4A7C15ull;
+static const quint64 s_mulHash = 0xBF58476D1CE4E5B9ull;
+
+static inline bool isSep(char16_t ch)
+{
+    return (ch == u'/') | (ch == u'\\');
+}
+
+static inline quint64 rotl(quint64 value, int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+static inline quint64 mix(quint64 hash, quint64 word)
+{
+    return rotl(hash ^ (word * s_mulWord), 29) * s_mulHash;
+}
+
+// MurmurHash3 finalizer: every bit of the input affects every bit of the result
+static inline quint64 finalize(quint64 hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static const quint64 s_laneHigh = 0x8000800080008000ull;
+static const quint64 s_laneLow = 0x7FFF7FFF7FFF7FFFull;
+static const quint64 s_lanes = 0x0001000100010001ull;
+
+// 4 code units at once
+static inline quint64 loadWord(const char16_t *data)
+{
+    quint64 word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// The high bit of each of the 4 code units which are 0
+static inline quint64 zeroLanes(quint64 word)
+{
+    return ~(((word & s_laneLow) + s_laneLow) | word | s_laneLow);
+}
+
+// 'A'-'Z' -> 'a'-'z' in each of the 4 code units of the <word>
+static inline quint64 foldWord(quint64 word)
+{
+    const quint64 low = word & s_laneLow;
+    const quint64 atLeastA = low + (s_laneHigh - 0x41 * s_lanes);
+    const quint64 atMostZ = (s_laneHigh + 0x5A * s_lanes) - low;
+    const quint64 upper = atLeastA & atMostZ & ~word & s_laneHigh;
+    return word + (upper >> 10);
+}
+
+// The end of the compared part: the ignored trailing separators are cut off, the root "/" is kept
+static int keyEnd(QStringView path, int options)
+{
+    const char16_t *data = path.utf16();
+    int end = path.size();
+
+    if (options & PathKey::TrailingSeparatorInsensitive) {
+        if (end > 1 && isSep(data[end - 1]))
+            --end;
+
+        while ((options & PathKey::SeparatorInsensitive) && end > 1 && isSep(data[end - 1]))
+            --end;
+    }
+
+    return end;
+}
+
+// True if the drive letter is changed: not folded, but uppercased
+static inline bool upperDrive(const char16_t *data, int end, int options)
+{
+    return (options & PathKey::DriveCaseInsensitive) && !(options & PathKey::CaseInsensitive)
+           && end > 1 && data[1] == u':' && data[0] >= u'a' && data[0] <= u'z';
+}
+
+/* The compared code units of a path, 4 at a time: '\\' is replaced with '/', the case is folded,
+ * the last word is padded with zeros. Unless the separators are duplicated: then the compared
+ * units are not at the same positions, and they are taken one by one by the KeyReader.
+ */
+class WordReader
+{
+public:
+    WordReader(QStringView path, int options)
+        : m_data(path.utf16())
+        , m_end(keyEnd(path, options))
+        , m_anySep(options & PathKey::SeparatorInsensitive)
+        , m_caseFold(options & PathKey::CaseInsensitive)
+        , m_upperDrive(upperDrive(m_data, m_end, options))
+    {}
+
+    const char16_t *data() const { return m_data; }
+    int end() const { return m_end; }
+
+    // Calls <func(word)> for each word, false if a duplicate separator is found
+    template <typename Func>
+    bool forEachWord(Func func) const
+    {
+        if (m_anySep)
+            return m_caseFold ? forEach<true, true>(func) : forEach<true, false>(func);
+
+        return m_caseFold ? forEach<false, true>(func) : forEach<false, false>(func);
+    }
+
+    // The word at the <pos> (a multiple of 4), false if a duplicate separator is found there
+    bool word(int pos, quint64 &word) const
+    {
+        if (m_anySep)
+            return m_caseFold ? wordAt<true, true>(pos, word) : wordAt<true, false>(pos, word);
+
+        return m_caseFold ? wordAt<false, true>(pos, word) : wordAt<false, false>(pos, word);
+    }
+
+private:
+    template <bool AnySep, bool CaseFold, typename Func>
+    bool forEach(Func func) const
+    {
+        quint64 word;
+        for (int pos = 0; pos < m_end; pos += 4) {
+            if (!wordAt<AnySep, CaseFold>(pos, word))
+                return false;
+            func(word);
+        }
+
+        return true;
+    }
+
+    template <bool AnySep, bool CaseFold>
+    bool wordAt(int pos, quint64 &word) const
+    {
+        quint64 units;
+
+        if (pos + 4 <= m_end && !(m_upperDrive && pos == 0)) {
+            units = loadWord(m_data + pos);
+        } else {
+            char16_t part[4] = {};
+            std::memcpy(part, m_data + pos, std::min(4, m_end - pos) * sizeof(char16_t));
+            if (m_upperDrive && pos == 0)
+                part[0] -= u'a' - u'A';
+            units = loadWord(part);
+        }
+
+        if (AnySep) {
+            // '\\' ^ 0x73 -> '/'
+            units ^= (zeroLanes(units ^ (u'\\' * s_lanes)) >> 15) * 0x73;
+
+            // the separators in a row, also the last one of the previous word and the first one
+            const quint64 slashes = zeroLanes(units ^ (u'/' * s_lanes));
+            const bool afterSep = (pos > 0) & isSep(m_data[pos > 0 ? pos - 1 : 0]) & isSep(m_data[pos]);
+            if ((slashes & (slashes << 16)) | quint64(afterSep))
+                return false;
+        }
+
+        word = CaseFold ? foldWord(units) : units;
+        return true;
+    }
+
+    const char16_t *m_data;
+    int m_end;
+    bool m_anySep;
+    bool m_caseFold;
+    bool m_upperDrive;
+};
+
+// The compared code units one by one, except for case folding; -1 at the end
+class KeyReader
+{
+public:
+    KeyReader(QStringView path, int options)
+        : m_data(path.utf16())
+        , m_end(keyEnd(path, options))
+        , m_anySep(options & PathKey::SeparatorInsensitive)
+        , m_upperDrive(upperDrive(m_data, m_end, options))
+    {}
+
+    int next()
+    {
+        while (m_pos < m_end) {
+            const char16_t ch = m_data[m_pos++];
+
+            if (m_anySep && isSep(ch)) {
+                if (m_afterSep)
+                    continue;
+                m_afterSep = true;
+                return u'/';
+            }
+
+            m_afterSep = false;
+            return (m_upperDrive && m_pos == 1) ? ch - (u'a' - u'A') : ch;
+        }
+
+        return -1;
+    }
+
+private:
+    const char16_t *m_data;
+    int m_pos = 0;
+    int m_end;
+    bool m_anySep;
+    bool m_upperDrive;
+    bool m_afterSep = false;
+};
+
+/*** PathKey ***/
+PathKey::PathKey(int options)
+    : m_options(options)
+{}
+
+size_t PathKey::hash(QStringView path) const
+{
+    const WordReader words(path, m_options);
+    quint64 hash = s_seed;
+    int size = words.end();
+
+    if (!words.forEachWord([&](quint64 word) { hash = mix(hash, word); })) {
+        // the same words from the units taken one by one
+        KeyReader reader(path, m_options);
+        hash = s_seed;
+        size = 0;
+
+        for (int ch = reader.next(); ch != -1;) {
+            char16_t part[4] = {};
+            for (int i = 0; i < 4 && ch != -1; ++i, ch = reader.next()) {
+                part[i] = ch;
+                ++size;
+            }
+
+            const quint64 word = loadWord(part);
+            hash = mix(hash, (m_options & CaseInsensitive) ? foldWord(word) : word);
+        }
+    }
+
+    // the size: "a" and "a\0" are different
+    return static_cast<size_t>(finalize(mix(hash, quint64(size))));
+}
+
+bool PathKey::equal(QStringView path1, QStringView path2) const
+{
+    if (m_options == Exact)
+        return path1 == path2;
+
+    const WordReader words1(path1, m_options);
+    const WordReader words2(path2, m_options);
+    const int end = words1.end();
+
+    if (end == words2.end()) {
+        // mostly the same strings
+        if (end == 0 || std::memcmp(words1.data(), words2.data(), end * sizeof(char16_t)) == 0)
+            return true;
+
+        quint64 word1;
+        quint64 word2;
+        int pos = 0;
+
+        for (; pos < end && words1.word(pos, word1) && words2.word(pos, word2); pos += 4) {
+            if (word1 != word2)
+                return false;
+        }
+
+        if (pos >= end)
+            return true;
+    } else if (!(m_options & SeparatorInsensitive)) {
+        return false;
+    }
+
+    KeyReader reader1(path1, m_options);
+    KeyReader reader2(path2, m_options);
+    const bool caseFold = m_options & CaseInsensitive;
+
+    for (;;) {
+        int ch1 = reader1.next();
+        int ch2 = reader2.next();
+
+        if (caseFold) {
+            ch1 = (ch1 == -1) ? ch1 : core::detail::foldAscii(ch1);
+            ch2 = (ch2 == -1) ? ch2 : core::detail::foldAscii(ch2);
+        }
+
+        if (ch1 != ch2)
+            return false;
+        if (ch1 == -1)
+            return true;
+    }
+}
+
+int PathKey::options() const
+{
+    return m_options;
+}
+
+size_t pathHash(QStringView path, int options)
+{
+    return PathKey(options).hash(path);
+}
+
+bool pathsEqual(QStringView path1, QStringView path2, int options)
+{
+    return PathKey(options).equal(path1, path2);
+}
+
+/*** PathSet ***/
+PathSet::PathSet(int options)
+    : m_key(options)
+{}
+
+PathSet::PathSet(const QStringList &paths, int options)
+    : m_key(options)
+{
+    reserve(paths.size());
+
+    for (const QString &path : paths)
+        insert(path);
+}
+
+int PathSet::insert(const QString &path)
+{
+    const quint32 hash = static_cast<quint32>(m_key.hash(path));
+
+    const int found = findHashed(path, hash);
+    if (found != -1)
+        return found;
+
+    m_paths.append(path);
+    m_index.insert(hash, size() - 1);
+
+    return size() - 1;
+}
+
+int PathSet::find(QStringView path) const
+{
+    return findHashed(path, static_cast<quint32>(m_key.hash(path)));
+}
+
+bool PathSet::contains(QStringView path) const
+{
+    return find(path) != -1;
+}
+
+QString PathSet::path(int index) const
+{
+    return (index < 0 || index >= size()) ? QString() : m_paths.at(index);
+}
+
+QStringList PathSet::paths() const
+{
+    return m_paths;
+}
+
+int PathSet::size() const
+{
+    return m_paths.size();
+}
+
+bool PathSet::isEmpty() const
+{
+    return m_paths.isEmpty();
+}
+
+void PathSet::reserve(int size)
+{
+    m_paths.reserve(size);
+    m_index.reserve(size);
+}
+
+PathKey PathSet::key() const
+{
+    return m_key;
+}
+
+int PathSet::findHashed(QStringView path, quint32 hash) const
+{
+    return m_index.find(hash, [&](int index) { return m_key.equal(m_paths.at(index), path); });
+}
+
+} // namespace pathstr
@@ -0,0 +1,109 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHKEY_H
+#define PATHKEY_H
+
+#include "hashtable_p.h"
+#include "pathstr.h"
+#include <QStringList>
+
+namespace pathstr {
+/* The hash and the equality of paths under an equivalence, in one pass over the strings
+ * without building the normalized ones. Nothing is allocated.
+ *
+ * const PathKey key; // Default
+ * key.equal(u"C:\\dir\\file", u"c:/dir//file/") -> true
+ * key.hash(u"C:\\dir\\file") == key.hash(u"c:/dir//file/")
+ *
+ * Unlike normalize(), the "." and ".." segments are compared as they are.
+ * Also a function object for the standard containers:
+ * std::unordered_set<QString, PathKey, PathKey> set(0, PathKey(), PathKey());
+ */
+class PathKey
+{
+public:
+    enum Option {
+        Exact = 0,
+        SeparatorInsensitive = 0x1,         // '\\' is the same as '/', duplicate separators are one
+        TrailingSeparatorInsensitive = 0x2, // the trailing separator is ignored (as in chopSep()), not of "/"
+        DriveCaseInsensitive = 0x4,         // "c:" is the same as "C:" (as in root())
+        CaseInsensitive = 0x8,              // ASCII letters only
+        Default = SeparatorInsensitive | TrailingSeparatorInsensitive | DriveCaseInsensitive
+    };
+
+    explicit PathKey(int options = Default);
+
+    size_t hash(QStringView path) const;
+    bool equal(QStringView path1, QStringView path2) const;
+
+    int options() const;
+
+    size_t operator()(QStringView path) const { return hash(path); }
+    bool operator()(QStringView path1, QStringView path2) const { return equal(path1, path2); }
+
+private:
+    int m_options = Default;
+};
+
+// PathKey(options).hash(path)
+size_t pathHash(QStringView path, int options = PathKey::Default);
+
+// PathKey(options).equal(path1, path2)
+bool pathsEqual(QStringView path1, QStringView path2, int options = PathKey::Default);
+
+/* A set of paths under the PathKey equivalence, for deduplicating paths from different sources.
+ * The first added of the equivalent paths is kept as it is. The paths are indexed
+ * in the order they are added, the indexes can be used for the values of a map.
+ *
+ * PathSet set;
+ * set.insert("C:\\dir\\file") -> 0
+ * set.insert("c:/dir/file/")  -> 0
+ * set.find(u"C:/dir//file")   -> 0
+ * set.path(0)                 -> "C:\\dir\\file"
+ */
+class PathSet
+{
+public:
+    explicit PathSet(int options = PathKey::Default);
+    explicit PathSet(const QStringList &paths, int options = PathKey::Default);
+
+    // Adds the <path>, returns its index. The index of the equivalent path is returned if there is one.
+    int insert(const QString &path);
+
+    // The index of the equivalent path, -1 if there is none
+    int find(QStringView path) const;
+    bool contains(QStringView path) const;
+
+    // The path as it was added
+    QString path(int index) const;
+
+    // The unique paths in the order they were added
+    QStringList paths() const;
+
+    int size() const;
+    bool isEmpty() const;
+    void reserve(int size);
+
+    PathKey key() const;
+
+private:
+    int findHashed(QStringView path, quint32 hash) const;
+
+    PathKey m_key;
+    QStringList m_paths;
+    core::detail::HashIndex m_index; // of m_paths, by the PathKey hashes
+};
+
+} // namespace pathstr
+
+#endif // PATHKEY_H
@@ -0,0 +1,220 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathlist.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pathstr {
+namespace core {
+/*** MappedPathList ***/
+MappedPathList::MappedPathList(const std::string &fileName)
+{
+    open(fileName);
+}
+
+MappedPathList::~MappedPathList()
+{
+    close();
+}
+
+#ifdef _WIN32
+bool MappedPathList::open(const std::string &fileName)
+{
+    close();
+
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+
+    // an empty file can't be mapped, it's just an empty list
+    if (m_size == 0)
+        return true;
+
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+        m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (!m_data) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedPathList::close()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+bool MappedPathList::isOpen() const
+{
+    return m_file != nullptr;
+}
+
+void MappedPathList::release(size_t, size_t) const
+{
+    // the working set is trimmed by the system
+}
+#else
+bool MappedPathList::open(const std::string &fileName)
+{
+    close();
+
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_size = static_cast<size_t>(st.st_size);
+
+    // an empty file can't be mapped, it's just an empty list
+    if (m_size == 0)
+        return true;
+
+    void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const char *>(data);
+    madvise(data, m_size, MADV_SEQUENTIAL);
+
+    return true;
+}
+
+void MappedPathList::close()
+{
+    if (m_data)
+        munmap(const_cast<char *>(m_data), m_size);
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    m_data = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+
+bool MappedPathList::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+void MappedPathList::release(size_t from, size_t to) const
+{
+    // whole pages only, the current line may share the last one
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    from = (from + pageSize - 1) / pageSize * pageSize;
+    to = to / pageSize * pageSize;
+
+    // the pages of the read-only file mapping are reloaded from the file if touched again
+    if (from < to)
+        madvise(const_cast<char *>(m_data) + from, to - from, MADV_DONTNEED);
+}
+#endif
+
+std::string_view MappedPathList::data() const
+{
+    return std::string_view(m_data, m_size);
+}
+
+/*** PathListWriter ***/
+PathListWriter::PathListWriter(const std::string &fileName, size_t bufferSize)
+    : m_file(std::fopen(fileName.c_str(), "wb"))
+    , m_buffer(bufferSize > 0 ? bufferSize : 1)
+{
+    // the own buffer is used
+    if (m_file)
+        std::setvbuf(m_file, nullptr, _IONBF, 0);
+}
+
+PathListWriter::~PathListWriter()
+{
+    if (m_file) {
+        flush();
+        std::fclose(m_file);
+    }
+}
+
+bool PathListWriter::isOpen() const
+{
+    return m_file != nullptr;
+}
+
+void PathListWriter::write(std::string_view line)
+{
+    if (!m_file)
+        return;
+
+    if (m_used + line.size() + 1 > m_buffer.size()) {
+        flush();
+
+        // longer than the buffer: written directly
+        if (line.size() + 1 > m_buffer.size()) {
+            m_failed |= (std::fwrite(line.data(), 1, line.size(), m_file) != line.size());
+            m_failed |= (std::fputc('\n', m_file) == EOF);
+            return;
+        }
+    }
+
+    std::memcpy(m_buffer.data() + m_used, line.data(), line.size());
+    m_used += line.size();
+    m_buffer[m_used++] = '\n';
+}
+
+bool PathListWriter::flush()
+{
+    if (m_file && m_used > 0) {
+        m_failed |= (std::fwrite(m_buffer.data(), 1, m_used, m_file) != m_used);
+        m_used = 0;
+    }
+
+    return m_file && !m_failed;
+}
+
+} // namespace core
+} // namespace pathstr
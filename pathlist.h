@@ -0,0 +1,289 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHLIST_H
+#define PATHLIST_H
+
+#include "casefold_p.h"
+#include "hashtable_p.h"
+#include "pathcore.h"
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace pathstr {
+namespace core {
+/* A newline-separated UTF-8 path list, mapped into memory read-only.
+ * The lines are passed as views into the mapping, nothing is copied.
+ * The pages are released behind the cursor, so the resident memory
+ * stays flat regardless of the file size.
+ *
+ * MappedPathList list("inventory.txt");
+ * list.forEachLine([](std::string_view path) { ... });
+ */
+class MappedPathList
+{
+public:
+    MappedPathList() = default;
+    explicit MappedPathList(const std::string &fileName);
+    ~MappedPathList();
+
+    MappedPathList(const MappedPathList &) = delete;
+    MappedPathList &operator=(const MappedPathList &) = delete;
+
+    bool open(const std::string &fileName);
+    void close();
+
+    bool isOpen() const;
+    std::string_view data() const;
+
+    /* Calls <func(path)> for every non-empty line, in order.
+     * The trailing '\r' is dropped, the views are valid until close().
+     */
+    template <typename Func>
+    void forEachLine(Func func) const;
+
+    // Gives the lines one by one, as forEachLine() does: for reading several lists side by side
+    class Reader
+    {
+    public:
+        explicit Reader(const MappedPathList &list) : m_list(list) {}
+
+        // Sets the <line> to the next non-empty line, false at the end
+        bool next(std::string_view &line);
+
+    private:
+        const MappedPathList &m_list;
+        size_t m_pos = 0;
+        size_t m_released = 0;
+    };
+
+private:
+    // Drops the mapped pages of [from, to) from the resident memory
+    void release(size_t from, size_t to) const;
+
+    static const size_t s_releaseStep = 64 << 20;
+
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+
+inline bool MappedPathList::Reader::next(std::string_view &line)
+{
+    const char *data = m_list.m_data;
+    const size_t size = m_list.m_size;
+
+    while (m_pos < size) {
+        const char *end = static_cast<const char *>(std::memchr(data + m_pos, '\n', size - m_pos));
+        const size_t lineEnd = end ? static_cast<size_t>(end - data) : size;
+        const size_t start = m_pos;
+        size_t lineSize = lineEnd - start;
+
+        if (lineSize > 0 && data[start + lineSize - 1] == '\r')
+            --lineSize;
+
+        m_pos = lineEnd + 1;
+
+        if (m_pos - m_released >= s_releaseStep) {
+            // the current line stays readable: the released pages are reloaded if touched
+            m_list.release(m_released, start);
+            m_released = start;
+        }
+
+        if (lineSize > 0) {
+            line = std::string_view(data + start, lineSize);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <typename Func>
+void MappedPathList::forEachLine(Func func) const
+{
+    Reader reader(*this);
+    std::string_view line;
+
+    while (reader.next(line))
+        func(line);
+}
+
+/* A set of UTF-8 file extensions, precompiled for matching many paths: the same results
+ * as hasExtension(path, ext) for any of them (ASCII case folding), see BasicExtensionSet.
+ *
+ * ExtensionSet set({ "jpg", ".PNG", "tar.gz" });
+ * set.insert(extFromConfig);
+ * set.matches("/folder/archive.TAR.GZ") -> true
+ */
+class ExtensionSet : public BasicExtensionSet<std::string_view, detail::FoldAscii>
+{
+public:
+    ExtensionSet() = default;
+
+    ExtensionSet(std::initializer_list<std::string_view> extensions)
+    {
+        for (std::string_view ext : extensions)
+            insert(ext);
+    }
+
+    // Any range of the string-like extensions: std::vector<std::string>...
+    template <typename Iterator>
+    ExtensionSet(Iterator first, Iterator last)
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+};
+
+/* Writes the lines to a file through a fixed size buffer, each one followed by '\n'.
+ * It can be passed as a sink to the functions below.
+ */
+class PathListWriter
+{
+public:
+    explicit PathListWriter(const std::string &fileName, size_t bufferSize = 1 << 20);
+    ~PathListWriter();
+
+    PathListWriter(const PathListWriter &) = delete;
+    PathListWriter &operator=(const PathListWriter &) = delete;
+
+    bool isOpen() const;
+
+    void write(std::string_view line);
+    void operator()(std::string_view line) { write(line); }
+
+    // Writes out the buffer, false on an i/o error
+    bool flush();
+
+private:
+    std::FILE *m_file = nullptr;
+    std::vector<char> m_buffer;
+    size_t m_used = 0;
+    bool m_failed = false;
+};
+
+/*** Streaming operations ***/
+/* The <sink> is any callable taking a std::string_view: a PathListWriter, a lambda...
+ * The views passed to it are valid during the call only.
+ */
+
+// The paths matching any of the <extensions>: one suffix lookup per line
+template <typename Sink>
+void filterByExtension(const MappedPathList &list, const ExtensionSet &extensions, Sink &&sink)
+{
+    list.forEachLine([&](std::string_view path) {
+        if (extensions.matches(path))
+            sink(path);
+    });
+}
+
+// filterByExtension(list, { "jpg", ".txt" }, sink)
+template <typename Sink>
+void filterByExtension(const MappedPathList &list, std::initializer_list<std::string_view> extensions, Sink &&sink)
+{
+    filterByExtension(list, ExtensionSet(extensions), sink);
+}
+
+// relativePath(rootFolder, path) of every path, the paths outside the <rootFolder> are skipped
+template <typename Sink>
+void relativePaths(const MappedPathList &list, std::string_view rootFolder, Sink &&sink)
+{
+    list.forEachLine([&](std::string_view path) {
+        const std::string_view rel = relativePath(rootFolder, path);
+        if (rel.data())
+            sink(rel);
+    });
+}
+
+// setSuffix(path, suf) of every path
+template <typename Sink>
+void setSuffixes(const MappedPathList &list, std::string_view suf, Sink &&sink)
+{
+    std::string buffer; // reused, grows up to the longest result
+
+    list.forEachLine([&](std::string_view path) {
+        const int sufSize = BasicPathInfo<std::string_view>(path).suffixSize();
+        buffer.assign(path.data(), path.size() - sufSize);
+
+        // joinStrings(path, suf, '.')
+        if (sufSize == 0 && !suf.empty()) {
+            const bool pathEnds = !buffer.empty() && buffer.back() == '.';
+            const bool sufStarts = suf.front() == '.';
+
+            if (pathEnds && sufStarts)
+                buffer.pop_back();
+            else if (!pathEnds && !sufStarts)
+                buffer.push_back('.');
+        }
+
+        buffer.append(suf);
+        sink(std::string_view(buffer));
+    });
+}
+
+/* Calls <sink(parentFolder, entryNames)> for each run of adjacent paths with the same parent folder.
+ * Inventories made by directory walks keep the folder contents together, so each folder
+ * makes one group; only the current group is kept in memory.
+ */
+template <typename Sink>
+void groupByParent(const MappedPathList &list, Sink &&sink)
+{
+    std::string_view parent;
+    std::vector<std::string_view> entries;
+    bool started = false;
+
+    list.forEachLine([&](std::string_view path) {
+        const BasicPathInfo<std::string_view> info(path);
+        const std::string_view curParent = info.parentFolder();
+
+        if (started && curParent != parent) {
+            sink(parent, entries);
+            entries.clear();
+        }
+
+        parent = curParent;
+        started = true;
+        entries.push_back(info.entryName());
+    });
+
+    if (started)
+        sink(parent, entries);
+}
+
+/* The difference of two lists sorted in the comparePaths() order, <sink(kind, path)>:
+ * the added and removed paths, the removed folders as a whole (see diffSorted()).
+ * Both lists are read side by side, the memory used does not depend on their size.
+ */
+template <typename Sink>
+void diffSnapshots(const MappedPathList &previous, const MappedPathList &current, Sink &&sink)
+{
+    MappedPathList::Reader prev(previous);
+    MappedPathList::Reader cur(current);
+
+    diffSorted<std::string_view>([&](std::string_view &path) { return prev.next(path); },
+                                 [&](std::string_view &path) { return cur.next(path); },
+                                 sink);
+}
+
+} // namespace core
+} // namespace pathstr
+
+#endif // PATHLIST_H
@@ -11,12 +11,35 @@
  */
 
 #include "pathstr.h"
+#include "pathinfo.h"
 #include <QStringBuilder>
 #include <QStringList>
+#include <cstring>
 
 namespace pathstr {
+// Returns the <view> of <str> as a QString, sharing the data if the view covers the whole string
+static QString toString(const QString &str, QStringView view)
+{
+    return (!view.isNull() && view.size() == str.size()) ? str : view.toString();
+}
+
+// str.toString().toLower(), the ASCII characters are lowered without the Unicode tables
+static QString toLower(QStringView str)
+{
+    QString result(str.size(), Qt::Uninitialized);
+    char16_t *data = reinterpret_cast<char16_t *>(result.data());
+
+    // the rest is lowered by Qt, the ASCII letters are already done
+    if (simd::lowerAscii(str.utf16(), data, str.size()) < str.size())
+        return std::move(result).toLower();
+
+    return result;
+}
+
 QString joinPath(const QString &absolutePath, const QString &addPath)
 {
+    PATHSTR_PROFILE_SCOPE(joinPath, absolutePath.size() + addPath.size());
+
     // 0, 1, 2
     qint8 sep_count = 0;
 
@@ -38,89 +61,141 @@ QString joinPath(const QString &absolutePath, const QString &addPath)
     }
 }
 
-QString entryName(const QString &path)
+QString joinPath(QString &&absolutePath, const QString &addPath)
 {
-    if (isRoot(path)) {
-        const QChar ch = path.at(0);
-        return ch.isLetter() ? QStringLiteral(u"Drive ") + ch.toUpper() : "Root";
-    }
+    PATHSTR_PROFILE_SCOPE(joinPath, absolutePath.size() + addPath.size());
 
-    // _sep == '/'
-    const bool endsWithSep = path.endsWith(s_sep);
-    const int lastSepInd = path.lastIndexOf(s_sep, -2);
+    joinPathInto(absolutePath, addPath);
+    return std::move(absolutePath);
+}
 
-    if (lastSepInd == -1) {
-        return endsWithSep ? path.chopped(1) : path;
-    }
+// The name of the root path: "/" -> "Root", "c:/" -> "Drive C"
+static QString rootName(const QString &path)
+{
+    const QChar ch = path.at(0);
+    return ch.isLetter() ? QStringLiteral(u"Drive ") + ch.toUpper() : "Root";
+}
+
+QString entryName(const QString &path)
+{
+    PATHSTR_PROFILE_SCOPE(entryName, path.size());
 
-    const int len = endsWithSep ? (path.size() - lastSepInd - 2) : -1;
-    return path.mid(lastSepInd + 1, len);
+    const PathInfo info(path);
+    return info.isRoot() ? rootName(path) : toString(path, info.entryName());
 }
 
 QString baseName(const QString &fileName)
 {
-    const QString file_name = entryName(fileName);
-    const int suffix_size = completeSuffixSize(fileName);
+    PATHSTR_PROFILE_SCOPE(baseName, fileName.size());
 
-    if (suffix_size == 0)
-        return file_name;
-
-    return file_name.left(file_name.size() - suffix_size - 1);
+    const PathInfo info(fileName);
+    return info.isRoot() ? rootName(fileName) : toString(fileName, info.baseName());
 }
 
 QString parentFolder(const QString &path)
 {
-    const int ind = path.lastIndexOf(s_sep, -2);
-
-    switch (ind) {
-    case -1: // root --> root; string'/' --> ""
-        return isRoot(path) ? path : QString();
-    case 0: // /folder'/' --> "/"
-        return path.at(ind);
-    case 2: // C:/folder'/' --> "C:/"
-        return isRoot(path.left(ind)) ? path.left(3) : path.left(ind);
-    default: // /folder/item'/' --> /folder
-        return path.left(ind);
-    }
+    PATHSTR_PROFILE_SCOPE(parentFolder, path.size());
+    return toString(path, parentFolderView(path));
 }
 
 QString relativePath(const QString &rootFolder, const QString &fullPath)
 {
-    if (rootFolder.isEmpty())
-        return fullPath;
+    PATHSTR_PROFILE_SCOPE(relativePath, rootFolder.size() + fullPath.size());
+    return toString(fullPath, relativePathView(rootFolder, fullPath));
+}
+
+// The parts of parentFolder/baseName.ext, with the joinPath() and joinStrings() rules
+struct FilePathParts
+{
+    QStringView parentFolder;
+    QStringView sep;
+    QStringView baseName;
+    QStringView dot;
+    QStringView ext;
 
-    if (!fullPath.startsWith(rootFolder))
-        return QString();
+    int size() const { return parentFolder.size() + sep.size() + baseName.size() + dot.size() + ext.size(); }
+};
 
-    // s_sep == u'/';
-    const int cut = rootFolder.endsWith(s_sep) ? rootFolder.size() - 1 : rootFolder.size();
+static FilePathParts filePathParts(QStringView parentFolder, QStringView baseName, QStringView ext)
+{
+    // joinStrings(baseName, ext, s_dot)
+    QStringView dot;
+
+    if (!ext.isEmpty()) {
+        const bool baseEnds = baseName.endsWith(s_dot);
+        const bool extStarts = ext.startsWith(s_dot);
+
+        if (baseEnds && extStarts)
+            baseName.chop(1);
+        else if (!baseEnds && !extStarts)
+            dot = QStringView(&s_dot, 1);
+    }
 
-    return ((cut < fullPath.size()) && (fullPath.at(cut) == s_sep)) ? fullPath.mid(cut + 1) : QString();
+    // joinPath(parentFolder, fileName)
+    QStringView sep;
 
-    // #2 impl. --> x2 slower due to (rootFolder + '/')
-    // const QString &_root = rootFolder.endsWith('/') ? rootFolder : rootFolder + '/';
-    // return fullPath.startsWith(_root) ? fullPath.mid(_root.size()) : QString();
+    if (!parentFolder.isEmpty()) {
+        const bool parentEnds = isSeparator(parentFolder.back());
+        const bool fileStarts = !baseName.isEmpty() ? isSeparator(baseName.front())
+                                                    : (dot.isEmpty() && !ext.isEmpty() && isSeparator(ext.front()));
+
+        if (parentEnds && fileStarts)
+            parentFolder.chop(1);
+        else if (!parentEnds && !fileStarts)
+            sep = QStringView(&s_sep, 1);
+    }
+
+    return { parentFolder, sep, baseName, dot, ext };
+}
+
+// parentFolder/baseName.ext, a single allocation
+static QString composeFilePath(QStringView parentFolder, QStringView baseName, QStringView ext)
+{
+    const FilePathParts parts = filePathParts(parentFolder, baseName, ext);
+
+    QString result;
+    result.reserve(parts.size());
+    result.append(parts.parentFolder).append(parts.sep).append(parts.baseName).append(parts.dot).append(parts.ext);
+
+    return result;
 }
 
 QString renameFile(const QString &oldName, const QString &newName)
 {
-    const QString &new_name = (completeSuffix(newName) == completeSuffix(oldName)) ? baseName(newName) : newName;
+    PATHSTR_PROFILE_SCOPE(renameFile, oldName.size() + newName.size());
+
+    const PathInfo oldInfo(oldName);
+    const PathInfo newInfo(newName);
+    const QString suffix = toLower(oldInfo.completeSuffix());
+
+    const bool sameSuffix = (newInfo.completeSuffix().compare(suffix, Qt::CaseInsensitive) == 0);
+    const QStringView new_name = sameSuffix ? newInfo.baseName() : QStringView(newName);
+
+    return composeFilePath(oldInfo.parentFolder(), new_name, suffix);
+}
+
+QString renameFile(QString &&oldName, const QString &newName)
+{
+    PATHSTR_PROFILE_SCOPE(renameFile, oldName.size() + newName.size());
 
-    return composeFilePath(parentFolder(oldName), new_name, completeSuffix(oldName));
+    renameFileInPlace(oldName, newName);
+    return std::move(oldName);
 }
 
 QString composeFilePath(const QString &parentFolder, const QString &baseName, const QString &ext)
 {
-    const QString &fileName = !ext.isEmpty() ? joinStrings(baseName, ext, s_dot) : baseName;
+    PATHSTR_PROFILE_SCOPE(composeFilePath, parentFolder.size() + baseName.size() + ext.size());
 
-    if (parentFolder.isEmpty())
-        return fileName;
+    if (parentFolder.isEmpty() && ext.isEmpty())
+        return baseName;
 
-    return joinPath(parentFolder, fileName);
+    return composeFilePath(QStringView(parentFolder), QStringView(baseName), QStringView(ext));
 }
 
 QString root(const QString &path)
 {
+    PATHSTR_PROFILE_SCOPE(root, path.size());
+
     // Unix-style fs root "/"
     if (path.startsWith(s_sep))
         return s_sep;
@@ -133,20 +208,34 @@ QString root(const QString &path)
     return QString();
 }
 
-QString suffix(const QString &fileName)
+QString suffix(const QString &fileName, bool lowerCase)
 {
-    const int len = suffixSize(fileName);
-    return (len > 0) ? fileName.right(len).toLower() : QString();
+    PATHSTR_PROFILE_SCOPE(suffix, fileName.size());
+
+    const QStringView suf = suffixView(fileName);
+
+    if (suf.isEmpty())
+        return QString();
+
+    return lowerCase ? toLower(suf) : suf.toString();
 }
 
-QString completeSuffix(const QString &fileName)
+QString completeSuffix(const QString &fileName, bool lowerCase)
 {
-    const int len = completeSuffixSize(fileName);
-    return (len > 0) ? fileName.right(len).toLower() : QString();
+    PATHSTR_PROFILE_SCOPE(completeSuffix, fileName.size());
+
+    const QStringView suf = completeSuffixView(fileName);
+
+    if (suf.isEmpty())
+        return QString();
+
+    return lowerCase ? toLower(suf) : suf.toString();
 }
 
 QString setSuffix(const QString &fileName, const QString &suf)
 {
+    PATHSTR_PROFILE_SCOPE(setSuffix, fileName.size() + suf.size());
+
     const int cur_suf_size = suffixSize(fileName);
 
     if (cur_suf_size == 0)
@@ -156,63 +245,36 @@ QString setSuffix(const QString &fileName, const QString &suf)
     return chopped % suf;
 }
 
-int suffixSize(const QString &fileName)
+QString setSuffix(QString &&fileName, const QString &suf)
 {
-    // in case: /folder.22/filename_with_no_dots
-    const QString file_name = entryName(fileName);
-    const int dot_ind = file_name.lastIndexOf(s_dot);
+    PATHSTR_PROFILE_SCOPE(setSuffix, fileName.size() + suf.size());
 
-    if (dot_ind < 1)
-        return 0;
+    setSuffixInPlace(fileName, suf);
+    return std::move(fileName);
+}
 
-    return file_name.size() - dot_ind - 1;
+int suffixSize(const QString &fileName)
+{
+    PATHSTR_PROFILE_SCOPE(suffixSize, fileName.size());
+    return PathInfo(fileName).suffixSize();
 }
 
 int completeSuffixSize(const QString &fileName)
 {
-    // in case: /folder.22/filename_with_no_dots
-    const QString file_name = entryName(fileName);
-    int ind_last_dot = -1;
-    int ind_prelast_dot = -1;
-
-    for (int i = (file_name.size() - 2); i >= 0; --i) {
-        if (file_name.at(i) == s_dot) {
-            if (ind_last_dot == -1) {
-                ind_last_dot = i;
-            } else {
-                ind_prelast_dot = i;
-                break;
-            }
-        }
-    }
-
-    if (ind_prelast_dot > 0)
-        return file_name.size() - ind_prelast_dot - 1;
-
-    if (ind_last_dot > 0)
-        return file_name.size() - ind_last_dot - 1;
-
-    return 0;
+    PATHSTR_PROFILE_SCOPE(completeSuffixSize, fileName.size());
+    return PathInfo(fileName).completeSuffixSize();
 }
 
 bool hasExtension(const QString &fileName, const QString &ext)
 {
-    if (ext.isEmpty())
-        return suffixSize(fileName) == 0;
-
-    // ".ext"
-    int dotInd = fileName.size() - ext.size();
-
-    // "ext"
-    if (ext.front() != s_dot)
-        --dotInd;
-
-    return ((dotInd > 0 && fileName.at(dotInd) == s_dot)
-            && fileName.endsWith(ext, Qt::CaseInsensitive));
+    PATHSTR_PROFILE_SCOPE(hasExtension, fileName.size() + ext.size());
+    return core::hasExtension(QStringView(fileName), QStringView(ext));
 }
 
 bool hasExtension(const QString &fileName, const QStringList &extensions)
 {
+    PATHSTR_PROFILE_SCOPE(hasExtension, fileName.size());
+
     for (const QString &ext : extensions) {
         if (hasExtension(fileName, ext))
             return true;
@@ -223,36 +285,50 @@ bool hasExtension(const QString &fileName, const QStringList &extensions)
 
 bool hasWindowsRoot(const QString &path)
 {
-    return path.size() > 1
-           && path.at(1) == u':'
-           && path.at(0).isLetter();
+    PATHSTR_PROFILE_SCOPE(hasWindowsRoot, path.size());
+    return hasWindowsRoot(QStringView(path));
+}
+
+bool hasWindowsRoot(QStringView path)
+{
+    PATHSTR_PROFILE_SCOPE(hasWindowsRoot, path.size());
+    return core::hasWindowsRoot(path);
 }
 
 bool isRoot(const QString &path)
 {
-    switch (path.length()) {
-    case 1:
-        return (path.at(0) == s_sep); // Linux FS root
-    case 2:
-    case 3:
-        return hasWindowsRoot(path);  // Windows drive root
-    default:
-        return false;
-    }
+    PATHSTR_PROFILE_SCOPE(isRoot, path.size());
+    return isRoot(QStringView(path));
+}
+
+bool isRoot(QStringView path)
+{
+    PATHSTR_PROFILE_SCOPE(isRoot, path.size());
+    return core::isRoot(path);
 }
 
 bool isAbsolute(const QString &path)
 {
-    return path.startsWith(s_sep) || hasWindowsRoot(path);
+    PATHSTR_PROFILE_SCOPE(isAbsolute, path.size());
+    return isAbsolute(QStringView(path));
+}
+
+bool isAbsolute(QStringView path)
+{
+    PATHSTR_PROFILE_SCOPE(isAbsolute, path.size());
+    return core::isAbsolute(path);
 }
 
 bool isRelative(const QString &path)
 {
+    PATHSTR_PROFILE_SCOPE(isRelative, path.size());
     return !isAbsolute(path);
 }
 
 QString joinStrings(const QString &str1, const QString &str2, QChar sep)
 {
+    PATHSTR_PROFILE_SCOPE(joinStrings, str1.size() + str2.size());
+
     const bool s1Ends = str1.endsWith(sep);
     const bool s2Starts = str2.startsWith(sep);
 
@@ -267,4 +343,378 @@ QString joinStrings(const QString &str1, const QString &str2, QChar sep)
     return str1 % sep % str2;
 }
 
+int comparePaths(QStringView path1, QStringView path2)
+{
+    PATHSTR_PROFILE_SCOPE(comparePaths, path1.size() + path2.size());
+    return core::comparePaths(path1, path2);
+}
+
+/*** In-place API ***/
+static inline void copyTo(QChar *dest, QStringView str)
+{
+    if (!str.isEmpty())
+        std::memcpy(dest, str.data(), str.size() * sizeof(QChar));
+}
+
+// str = str.left(keep) + sep + add, the data of the <str> is reused
+static void replaceEnd(QString &str, int keep, QStringView sep, QStringView add)
+{
+    str.resize(keep + sep.size() + add.size());
+    QChar *data = str.data();
+    copyTo(data + keep, sep);
+    copyTo(data + keep + sep.size(), add);
+}
+
+void setSuffixInPlace(QString &fileName, QStringView suf)
+{
+    PATHSTR_PROFILE_SCOPE(setSuffixInPlace, fileName.size() + suf.size());
+
+    const int cur_suf_size = suffixSize(fileName);
+
+    if (cur_suf_size > 0) {
+        replaceEnd(fileName, fileName.size() - cur_suf_size, QStringView(), suf);
+        return;
+    }
+
+    // joinStrings(fileName, suf, s_dot)
+    const bool nameEnds = fileName.endsWith(s_dot);
+    const bool sufStarts = suf.startsWith(s_dot);
+    const QStringView dot = (nameEnds || sufStarts) ? QStringView() : QStringView(&s_dot, 1);
+
+    replaceEnd(fileName, (nameEnds && sufStarts) ? fileName.size() - 1 : fileName.size(), dot, suf);
+}
+
+void joinPathInto(QString &dst, QStringView addPath)
+{
+    PATHSTR_PROFILE_SCOPE(joinPathInto, dst.size() + addPath.size());
+
+    const bool dstEnds = endsWithSep(dst);
+    const bool addStarts = !addPath.isEmpty() && isSeparator(addPath.front());
+    const QStringView sep = (dstEnds || addStarts) ? QStringView() : QStringView(&s_sep, 1);
+
+    replaceEnd(dst, (dstEnds && addStarts) ? dst.size() - 1 : dst.size(), sep, addPath);
+}
+
+static bool isAscii(QStringView str)
+{
+    for (const QChar ch : str) {
+        if (ch.unicode() > 0x7F)
+            return false;
+    }
+
+    return true;
+}
+
+void renameFileInPlace(QString &path, QStringView newName)
+{
+    PATHSTR_PROFILE_SCOPE(renameFileInPlace, path.size() + newName.size());
+
+    const PathInfo oldInfo(path);
+    const PathInfo newInfo(newName);
+    const QStringView suffix = oldInfo.completeSuffix();
+
+    // the lowered suffix is the same size only if it's ASCII
+    if (!isAscii(suffix)) {
+        path = renameFile(static_cast<const QString &>(path), newName.toString());
+        return;
+    }
+
+    const bool sameSuffix = (newInfo.completeSuffix().compare(suffix, Qt::CaseInsensitive) == 0);
+    const FilePathParts parts = filePathParts(oldInfo.parentFolder(), sameSuffix ? newInfo.baseName() : newName, suffix);
+
+    // the parent folder is the start of the <path>, the suffix is moved after the new name
+    const int oldSize = path.size();
+    const int newSize = parts.size();
+    const int nameStart = parts.parentFolder.size() + parts.sep.size();
+    const int extFrom = suffix.isEmpty() ? 0 : int(suffix.data() - path.constData());
+    const int extTo = newSize - parts.ext.size();
+    const int extSize = parts.ext.size();
+    const QStringView sep = parts.sep;
+    const QStringView dot = parts.dot;
+    const QStringView name = parts.baseName;
+
+    if (newSize > oldSize)
+        path.resize(newSize);
+
+    QChar *data = path.data();
+    std::memmove(data + extTo, data + extFrom, extSize * sizeof(QChar));
+
+    char16_t *ext = reinterpret_cast<char16_t *>(data + extTo);
+    simd::lowerAscii(ext, ext, extSize);
+
+    copyTo(data + nameStart - sep.size(), sep);
+    copyTo(data + nameStart, name);
+    copyTo(data + nameStart + name.size(), dot);
+
+    if (newSize < oldSize)
+        path.truncate(newSize);
+}
+
+
+/*** Zero-allocation API ***/
+QStringView entryNameView(QStringView path)
+{
+    PATHSTR_PROFILE_SCOPE(entryNameView, path.size());
+    return PathInfo(path).entryName();
+}
+
+QStringView baseNameView(QStringView fileName)
+{
+    PATHSTR_PROFILE_SCOPE(baseNameView, fileName.size());
+    return PathInfo(fileName).baseName();
+}
+
+QStringView parentFolderView(QStringView path)
+{
+    PATHSTR_PROFILE_SCOPE(parentFolderView, path.size());
+    return PathInfo(path).parentFolder();
+}
+
+QStringView relativePathView(QStringView rootFolder, QStringView fullPath)
+{
+    PATHSTR_PROFILE_SCOPE(relativePathView, rootFolder.size() + fullPath.size());
+    return core::relativePath(rootFolder, fullPath);
+}
+
+QStringView commonAncestorView(QStringView path1, QStringView path2)
+{
+    PATHSTR_PROFILE_SCOPE(commonAncestorView, path1.size() + path2.size());
+    return core::commonAncestor(path1, path2);
+}
+
+QStringView rootView(QStringView path)
+{
+    PATHSTR_PROFILE_SCOPE(rootView, path.size());
+    return core::root(path);
+}
+
+QStringView suffixView(QStringView fileName)
+{
+    PATHSTR_PROFILE_SCOPE(suffixView, fileName.size());
+    return PathInfo(fileName).suffix();
+}
+
+QStringView completeSuffixView(QStringView fileName)
+{
+    PATHSTR_PROFILE_SCOPE(completeSuffixView, fileName.size());
+    return PathInfo(fileName).completeSuffix();
+}
+
+// toLower(str) written to the <buffer>
+static QStringView toLower(QStringView str, QString &buffer)
+{
+    if (str.isEmpty())
+        return QStringView();
+
+    buffer.resize(str.size());
+    char16_t *data = reinterpret_cast<char16_t *>(buffer.data());
+
+    if (simd::lowerAscii(str.utf16(), data, str.size()) < str.size())
+        buffer = buffer.toLower();
+
+    return buffer;
+}
+
+QStringView lowerSuffixView(QStringView fileName, QString &buffer)
+{
+    PATHSTR_PROFILE_SCOPE(lowerSuffixView, fileName.size());
+    return toLower(suffixView(fileName), buffer);
+}
+
+QStringView lowerCompleteSuffixView(QStringView fileName, QString &buffer)
+{
+    PATHSTR_PROFILE_SCOPE(lowerCompleteSuffixView, fileName.size());
+    return toLower(completeSuffixView(fileName), buffer);
+}
+
+
+/*** Normalization ***/
+// The Windows root without a separator ("C:", "C:folder") gets one, the result is longer
+static bool rootSepMissing(QStringView path, bool backslashSep)
+{
+    if (!hasWindowsRoot(path))
+        return false;
+
+    return path.size() == 2 || !(path.at(2) == s_sep || (backslashSep && path.at(2) == u'\\'));
+}
+
+/* Writes the normalized <path> to the <out> (path.size() + 1 chars at most), returns the size.
+ * The <out> may be the <path> data if the root separator is not missing:
+ * nothing is written ahead of the read position.
+ */
+static int normalizeTo(QStringView path, QChar *out, bool backslashSep)
+{
+    auto isSep = [backslashSep](QChar ch) { return ch == s_sep || (backslashSep && ch == u'\\'); };
+
+    const QChar *in = path.data();
+    const int size = path.size();
+    int r = 0; // read position
+    int w = 0; // write position
+
+    if (hasWindowsRoot(path)) {
+        r = (size > 2 && isSep(in[2])) ? 3 : 2;
+        out[0] = in[0].toUpper();
+        out[1] = u':';
+        out[2] = s_sep;
+        w = 3;
+    } else if (size > 0 && isSep(in[0])) {
+        out[0] = s_sep;
+        r = w = 1;
+    }
+
+    const int rootEnd = w;
+
+    while (r < size) {
+        while (r < size && isSep(in[r]))
+            ++r;
+
+        if (r == size)
+            break;
+
+        const int segStart = r;
+        while (r < size && !isSep(in[r]))
+            ++r;
+
+        const int segSize = r - segStart;
+
+        if (in[segStart] == s_dot && segSize == 1)
+            continue;
+
+        if (in[segStart] == s_dot && segSize == 2 && in[segStart + 1] == s_dot) {
+            if (w > rootEnd) {
+                // the last written segment
+                int prev = w - 1;
+                while (prev >= rootEnd && out[prev] != s_sep)
+                    --prev;
+
+                const bool prevIsDots = (w - prev == 3) && out[prev + 1] == s_dot && out[prev + 2] == s_dot;
+                if (!prevIsDots) {
+                    w = qMax(prev, rootEnd);
+                    continue;
+                }
+            } else if (rootEnd > 0) {
+                // "/.." -> "/"
+                continue;
+            }
+        }
+
+        if (w > rootEnd) {
+            out[w++] = s_sep;
+        } else if (w == 0 && hasWindowsRoot(QStringView(in + segStart, segSize))) {
+            // "./C:folder" is not "C:/folder", the "./" was read already
+            out[w++] = s_dot;
+            out[w++] = s_sep;
+        }
+
+        std::memmove(out + w, in + segStart, segSize * sizeof(QChar));
+        w += segSize;
+    }
+
+    if (w == 0 && size > 0)
+        out[w++] = s_dot;
+
+    return w;
+}
+
+QString normalize(const QString &path, bool backslashSep)
+{
+    PATHSTR_PROFILE_SCOPE(normalize, path.size());
+
+    if (isNormalized(path, backslashSep))
+        return path;
+
+    QString result(path.size() + 1, Qt::Uninitialized);
+    result.truncate(normalizeTo(path, result.data(), backslashSep));
+    return result;
+}
+
+QString normalize(QString &&path, bool backslashSep)
+{
+    PATHSTR_PROFILE_SCOPE(normalize, path.size());
+
+    if (isNormalized(path, backslashSep))
+        return std::move(path);
+
+    if (rootSepMissing(path, backslashSep))
+        return normalize(static_cast<const QString &>(path), backslashSep);
+
+    // in place, the shared data is detached
+    QChar *data = path.data();
+    path.truncate(normalizeTo(QStringView(data, path.size()), data, backslashSep));
+    return std::move(path);
+}
+
+QStringView normalize(QStringView path, QString &buffer, bool backslashSep)
+{
+    PATHSTR_PROFILE_SCOPE(normalize, path.size());
+
+    if (isNormalized(path, backslashSep))
+        return path;
+
+    buffer.resize(path.size() + 1);
+    buffer.truncate(normalizeTo(path, buffer.data(), backslashSep));
+    return buffer;
+}
+
+bool isNormalized(QStringView path, bool backslashSep)
+{
+    PATHSTR_PROFILE_SCOPE(isNormalized, path.size());
+
+    const char16_t *data = path.utf16();
+    const int size = path.size();
+    int pos = 0;
+
+    if (hasWindowsRoot(path)) {
+        if (size < 3 || data[2] != u'/' || path.at(0) != path.at(0).toUpper())
+            return false;
+        pos = 3;
+    } else if (size > 0 && data[0] == u'/') {
+        pos = 1;
+    }
+
+    // "", "/", "C:/", "."
+    if (pos == size || (size == 1 && data[0] == u'.'))
+        return true;
+
+    // the trailing separator
+    if (data[size - 1] == u'/')
+        return false;
+
+    // "./C:folder"
+    if (pos == 0 && size > 2 && data[0] == u'.' && data[1] == u'/' && hasWindowsRoot(path.mid(2)))
+        pos = 2;
+
+    // ".." segments are only allowed at the start of a relative path
+    bool leadingDots = (pos == 0);
+
+    // <pos> is the start of a segment, it's not the end of the path
+    while (true) {
+        if (data[pos] == u'/')
+            return false;
+
+        if (data[pos] == u'.') {
+            const bool endsAt1 = (pos + 1 == size || data[pos + 1] == u'/');
+            const bool dotDot = !endsAt1 && data[pos + 1] == u'.' && (pos + 2 == size || data[pos + 2] == u'/');
+
+            if (endsAt1 || (dotDot && !leadingDots))
+                return false;
+
+            leadingDots = dotDot;
+        } else {
+            leadingDots = false;
+        }
+
+        while (pos < size && data[pos] != u'/') {
+            if (backslashSep && data[pos] == u'\\')
+                return false;
+            ++pos;
+        }
+
+        if (pos == size)
+            return true;
+
+        ++pos;
+    }
+}
+
 } // namespace pathstr
@@ -32,7 +32,10 @@
 #ifndef PATHSTR_H
 #define PATHSTR_H
 
+#include "profile.h"
 #include <QString>
+#include <QStringView>
+#include <utility>
 
 namespace pathstr {
 /*** Constants ***/
@@ -47,6 +50,9 @@ static const QChar s_dot = u'.';
  */
 QString joinPath(const QString &absolutePath, const QString &addPath);
 
+// The same, the data of the <absolutePath> is reused
+QString joinPath(QString &&absolutePath, const QString &addPath);
+
 /* Returns the name of the file system entry (file or folder)
  * regardless of the separator presence at the end of the path:
  * "/folder/fooEntry/"       -> "fooEntry"
@@ -86,6 +92,9 @@ QString relativePath(const QString &rootFolder, const QString &fullPath);
  */
 QString renameFile(const QString &oldName, const QString &newName);
 
+// The same, the data of the <oldName> is reused
+QString renameFile(QString &&oldName, const QString &newName);
+
 // parentFolder/baseName.ext
 QString composeFilePath(const QString &parentFolder,
                         const QString &baseName, const QString &ext);
@@ -97,11 +106,12 @@ QString composeFilePath(const QString &parentFolder,
 QString root(const QString &path);
 
 /* Returns the suffix (extension) of the <fileName>.
+ * If <lowerCase> is false, the suffix is returned as is.
  * "file.txt"         -> "txt"
  * "archive.tar.gz"   -> "gz"
  * ".hidden_file"     -> ""
  */
-QString suffix(const QString &fileName);
+QString suffix(const QString &fileName, bool lowerCase = true);
 
 /* Returns the complete suffix (extension) of the <fileName>.
  * The last two dots at most are taken into account.
@@ -110,8 +120,10 @@ QString suffix(const QString &fileName);
  * "file.name.with.dots.tar.gz" -> "tar.gz"
  * "/folder/archive.zip"        -> "zip"
  * "folder.name/.archive.zip"   -> "zip"
+ *
+ * If <lowerCase> is false, the suffix is returned as is.
  */
-QString completeSuffix(const QString &fileName);
+QString completeSuffix(const QString &fileName, bool lowerCase = true);
 
 /* Sets or changes an existing filename suffix
  * setSuffix("file", "zip")     -> "file.zip"
@@ -119,6 +131,9 @@ QString completeSuffix(const QString &fileName);
  */
 QString setSuffix(const QString &fileName, const QString &suf);
 
+// The same, the data of the <fileName> is reused
+QString setSuffix(QString &&fileName, const QString &suf);
+
 /* Returns the size of the suffix.
  * If the file name begins with a dot (Linux hidden file), it matters.
  * "/folder/file.txt" -> 3
@@ -146,17 +161,24 @@ bool hasExtension(const QString &fileName, const QString &ext);
 /* True if the <fileName> has any extension from the list.
  * hasExtension("file.txt", {"jpg", "txt", "json"}) -> true
  * hasExtension("file.txt", {"zip", "cpp", "epub"}) -> false
+ *
+ * The slow path: each extension is checked in turn, O(extensions) per call. For matching
+ * many file names build an ExtensionSet (extensionset.h) once and use
+ * hasExtension(fileName, ExtensionSet) or ExtensionSet::matches(), one suffix scan per name.
  */
 bool hasExtension(const QString &fileName, const QStringList &extensions);
 
 // true if starts with "X:"
 bool hasWindowsRoot(const QString &path);
+bool hasWindowsRoot(QStringView path);
 
 // true: "/" or "X:[/]"; else false
 bool isRoot(const QString &path);
+bool isRoot(QStringView path);
 
 // true if the <path> starts with '/' or 'X:'
 bool isAbsolute(const QString &path);
+bool isAbsolute(QStringView path);
 
 // true if the path is not Absolute
 bool isRelative(const QString &path);
@@ -164,34 +186,171 @@ bool isRelative(const QString &path);
 // true if '/' or '\\'
 inline bool isSeparator(const QChar sep)
 {
+    PATHSTR_PROFILE_SCOPE(isSeparator, 1);
     return (sep == s_sep) || (sep == '\\');
 }
 
 // true if the <path> string ends with a slash or backslash (path separator '/' or '\\')
 inline bool endsWithSep(const QString &path)
 {
+    PATHSTR_PROFILE_SCOPE(endsWithSep, path.size());
     return !path.isEmpty() && isSeparator(path.back());
 }
 
 // ...starts with
 inline bool startsWithSep(const QString &path)
 {
+    PATHSTR_PROFILE_SCOPE(startsWithSep, path.size());
     return !path.isEmpty() && isSeparator(path.front());
 }
 
 // Appends '/' if not any
 inline QString appendSep(const QString &path)
 {
+    PATHSTR_PROFILE_SCOPE(appendSep, path.size());
     return path.endsWith(s_sep) ? path : path + s_sep;
 }
 
 // If the <path> ends with a separator, remove it
 inline QString chopSep(const QString &path)
 {
+    PATHSTR_PROFILE_SCOPE(chopSep, path.size());
     return endsWithSep(path) ? path.chopped(1) : path;
 }
 
 
+/*** In-place API ***/
+/* The functions below change the passed string instead of building a new one.
+ * Its data is detached if shared, the spare capacity is reused: a string reused
+ * for many paths is not reallocated. A QString&& overload of the same name does
+ * the same and returns the string. The passed views must not refer to its data.
+ */
+
+// path = appendSep(path)
+inline void appendSepInPlace(QString &path)
+{
+    PATHSTR_PROFILE_SCOPE(appendSepInPlace, path.size());
+
+    if (!path.endsWith(s_sep))
+        path.append(s_sep);
+}
+
+inline QString appendSep(QString &&path)
+{
+    PATHSTR_PROFILE_SCOPE(appendSep, path.size());
+
+    appendSepInPlace(path);
+    return std::move(path);
+}
+
+// path = chopSep(path)
+inline void chopSepInPlace(QString &path)
+{
+    PATHSTR_PROFILE_SCOPE(chopSepInPlace, path.size());
+
+    if (endsWithSep(path))
+        path.chop(1);
+}
+
+inline QString chopSep(QString &&path)
+{
+    PATHSTR_PROFILE_SCOPE(chopSep, path.size());
+
+    chopSepInPlace(path);
+    return std::move(path);
+}
+
+// fileName = setSuffix(fileName, suf)
+void setSuffixInPlace(QString &fileName, QStringView suf);
+
+// dst = joinPath(dst, addPath)
+void joinPathInto(QString &dst, QStringView addPath);
+
+// path = renameFile(path, newName)
+void renameFileInPlace(QString &path, QStringView newName);
+
+
+/*** Zero-allocation API ***/
+/* The functions below return views into the passed string, nothing is allocated or copied.
+ * The result is valid as long as the data of the input string is alive and unchanged.
+ * Suffixes are returned as is (no case-lowering).
+ */
+
+/* The same as entryName(), but root paths have no entry name:
+ * "/folder/fooEntry/" -> "fooEntry"
+ * "/"                 -> ""
+ */
+QStringView entryNameView(QStringView path);
+
+// "/folder/archive.tar.gz" -> "archive"
+QStringView baseNameView(QStringView fileName);
+
+// "/folder/file_or_folder2/" -> "/folder"
+QStringView parentFolderView(QStringView path);
+
+// relativePathView(u"/rootFolder", u"/rootFolder/folder2/file") -> "folder2/file"
+QStringView relativePathView(QStringView rootFolder, QStringView fullPath);
+
+/* The deepest folder containing both paths, a view into the <path1>; see commonAncestor() (batch.h)
+ * (u"/folder/folder2/file", u"/folder/file2") -> "/folder"
+ * (u"/folder", u"/folder/file")               -> "/folder"
+ * (u"/folder//file", u"/folder/file")         -> "/folder//file"
+ * (u"C:/folder", u"D:/folder")                -> null
+ */
+QStringView commonAncestorView(QStringView path1, QStringView path2);
+
+/* Unlike root(), the drive letter and the separator are kept as is:
+ * "/home/folder" -> "/"
+ * "c:\\folder"   -> "c:\\"
+ * "c:"           -> "c:"
+ */
+QStringView rootView(QStringView path);
+
+// "archive.tar.GZ" -> "GZ"
+QStringView suffixView(QStringView fileName);
+
+// "/folder/archive.tar.GZ" -> "tar.GZ"
+QStringView completeSuffixView(QStringView fileName);
+
+/* The lowercase suffix, the same as suffix() returns, written to the <buffer>
+ * (its capacity is reused): nothing is allocated for the ASCII suffixes.
+ * lowerSuffixView(u"archive.tar.GZ", buffer) -> "gz"; no suffix -> null
+ */
+QStringView lowerSuffixView(QStringView fileName, QString &buffer);
+
+// The same for the complete suffix: "/folder/archive.TAR.gz" -> "tar.gz"
+QStringView lowerCompleteSuffixView(QStringView fileName, QString &buffer);
+
+
+/*** Normalization ***/
+/* Lexical normalization, done in one pass without touching the file system:
+ * duplicate separators are collapsed, "." segments are removed, ".." segments remove
+ * the previous ones (kept at the start of a relative path, dropped at the root),
+ * the trailing separator is removed. The root becomes as root() returns it: "/", "C:/".
+ * An empty relative result is ".", a relative one starting with "X:" keeps the "./" prefix.
+ * If <backslashSep> is false, '\\' is an ordinary character, else it's a separator turned into '/'.
+ *
+ * normalize("/home//folder/./file")      -> "/home/folder/file"
+ * normalize("c:\\folder\\..\\folder2\\") -> "C:/folder2"
+ * normalize("../folder/../file")         -> "../file"
+ * normalize("folder/..")                 -> "."
+ *
+ * Already normalized paths are returned as is, nothing is allocated.
+ */
+QString normalize(const QString &path, bool backslashSep = true);
+
+// The same, the data of the <path> is reused
+QString normalize(QString &&path, bool backslashSep = true);
+
+/* The result is written to the <buffer> (its capacity is reused), or the <path> itself
+ * is returned if it's already normalized. The <buffer> must not hold the <path> data.
+ */
+QStringView normalize(QStringView path, QString &buffer, bool backslashSep = true);
+
+// true if normalize() would return the <path> unchanged
+bool isNormalized(QStringView path, bool backslashSep = true);
+
+
 /*** Additional tools ***/
 /* Join strings with the specified separator ('sep'),
  * checks for the absence of 'sep' duplication:
@@ -201,6 +360,12 @@ inline QString chopSep(const QString &path)
  */
 QString joinStrings(const QString &str1, const QString &str2, QChar sep);
 
+/* The path order: '/' sorts before any other character, so the contents of a folder
+ * follow it without other entries in between. Returns <0, 0 or >0, as QString::compare().
+ * "/a" < "/a/z" < "/a-b" < "/ab"
+ */
+int comparePaths(QStringView path1, QStringView path2);
+
 } // namespace pathstr
 
 #endif // PATHSTR_H
@@ -0,0 +1,41 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHSTR_P_H
+#define PATHSTR_P_H
+
+#include "casefold_p.h"
+#include <QChar>
+#include <algorithm>
+#include <thread>
+
+/* Internal, not a part of the API: the helpers shared by the Qt sources */
+
+namespace pathstr {
+// Case folding of a single code unit, ASCII is handled without the Unicode tables
+inline char16_t foldCase(char16_t ch)
+{
+    if (ch < 0x80)
+        return core::detail::foldAscii(ch);
+
+    return QChar(ch).toCaseFolded().unicode();
+}
+
+// The number of workers for <threads>, 0 -> all hardware threads
+inline int workerCount(int threads)
+{
+    return (threads > 0) ? threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+} // namespace pathstr
+
+#endif // PATHSTR_P_H
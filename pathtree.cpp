@@ -0,0 +1,281 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "pathtree.h"
+#include "pathstr.h"
+#include "simd.h"
+#include <cstring>
+
+namespace pathstr {
+static quint32 hashName(QStringView name)
+{
+    return core::detail::hashUnits(name.utf16(), name.size());
+}
+
+static inline quint32 hashChild(int parent, int name)
+{
+    const quint64 key = (quint64(quint32(parent)) << 32 | quint32(name)) * 0x9E3779B97F4A7C15ULL;
+    return quint32(key >> 32);
+}
+
+// The next non-empty '/' separated component from the <pos>, false if there is none
+static bool nextComponent(QStringView path, int &pos, QStringView &component)
+{
+    while (pos < path.size() && path.at(pos) == s_sep)
+        ++pos;
+
+    if (pos == path.size())
+        return false;
+
+    int end = path.indexOf(s_sep, pos);
+    if (end == -1)
+        end = path.size();
+
+    component = path.mid(pos, end - pos);
+    pos = end;
+    return true;
+}
+
+PathTree::PathTree()
+    : m_namePool(1 << 16)
+{}
+
+PathTree::Handle PathTree::insert(QStringView path)
+{
+    const int size = path.size();
+    const int rootSize = rootView(path).size();
+    const int lastRootSize = rootView(m_lastPath).size();
+
+    // the components shared with the previous path
+    size_t reused = 0;
+
+    if (rootSize == lastRootSize) {
+        const int common = simd::mismatch(path.utf16(), m_lastPath.utf16(), qMin(size, int(m_lastPath.size())));
+
+        while (reused < m_lastEnds.size()) {
+            const int end = m_lastEnds[reused];
+
+            if (end > common)
+                break;
+
+            // the root component is the same as the root sizes are; a name must end here in both paths
+            if (!(reused == 0 && rootSize > 0) && end < size && path.at(end) != s_sep)
+                break;
+
+            ++reused;
+        }
+    }
+
+    m_lastEnds.resize(reused);
+    m_lastNodes.resize(reused);
+
+    Handle node = reused ? m_lastNodes.back() : s_none;
+    int pos = reused ? m_lastEnds.back() : 0;
+
+    if (reused == 0 && rootSize > 0) {
+        node = addChild(s_none, path.left(rootSize));
+        m_lastEnds.push_back(rootSize);
+        m_lastNodes.push_back(node);
+        pos = rootSize;
+    }
+
+    QStringView component;
+    while (nextComponent(path, pos, component)) {
+        node = addChild(node, component);
+        m_lastEnds.push_back(pos);
+        m_lastNodes.push_back(node);
+    }
+
+    m_lastPath.truncate(0);
+    m_lastPath.append(path);
+
+    return node;
+}
+
+QVector<PathTree::Handle> PathTree::insert(const QStringList &paths)
+{
+    QVector<Handle> handles;
+    handles.reserve(paths.size());
+
+    for (const QString &path : paths)
+        handles.append(insert(path));
+
+    return handles;
+}
+
+PathTree::Handle PathTree::insertChild(Handle parent, QStringView name)
+{
+    return addChild(parent, name);
+}
+
+PathTree::Handle PathTree::child(Handle parent, QStringView name) const
+{
+    const int nameInd = findName(name, hashName(name));
+    return (nameInd == -1) ? s_none : findChild(parent, nameInd, hashChild(parent, nameInd));
+}
+
+PathTree::Handle PathTree::find(QStringView path) const
+{
+    const int rootSize = rootView(path).size();
+    Handle node = s_none;
+    int pos = 0;
+
+    if (rootSize > 0) {
+        node = child(s_none, path.left(rootSize));
+        pos = rootSize;
+    }
+
+    QStringView component;
+    while ((node != s_none || pos == 0) && nextComponent(path, pos, component))
+        node = child(node, component);
+
+    return node;
+}
+
+QString PathTree::path(Handle node) const
+{
+    return relativePath(s_none, node);
+}
+
+QStringView PathTree::entryName(Handle node) const
+{
+    return (node < 0 || node >= size()) ? QStringView() : m_names[m_nodes[node].name];
+}
+
+PathTree::Handle PathTree::parent(Handle node) const
+{
+    return (node < 0 || node >= size()) ? s_none : m_nodes[node].parent;
+}
+
+int PathTree::depth(Handle node) const
+{
+    return (node < 0 || node >= size()) ? 0 : m_nodes[node].depth;
+}
+
+bool PathTree::isAncestor(Handle folder, Handle node) const
+{
+    if (depth(node) <= depth(folder))
+        return false;
+
+    while (depth(node) > depth(folder))
+        node = m_nodes[node].parent;
+
+    return node == folder;
+}
+
+QString PathTree::relativePath(Handle folder, Handle node) const
+{
+    if (folder != s_none && !isAncestor(folder, node))
+        return QString();
+
+    if (node < 0 || node >= size())
+        return QString();
+
+    // no separator after the root ending with one: "/", "C:/"
+    auto sepBefore = [this, folder](Handle n) {
+        const Handle par = m_nodes[n].parent;
+        if (par == folder)
+            return false;
+
+        const QStringView parName = m_names[m_nodes[par].name];
+        return m_nodes[par].parent != s_none || !isSeparator(parName.back()) || !isRoot(parName);
+    };
+
+    // #1 pass: the size; #2 pass: the names are copied from the end
+    int resultSize = 0;
+    for (Handle n = node; n != folder; n = m_nodes[n].parent)
+        resultSize += m_names[m_nodes[n].name].size() + sepBefore(n);
+
+    QString result(resultSize, Qt::Uninitialized);
+    QChar *out = result.data() + resultSize;
+
+    for (Handle n = node; n != folder; n = m_nodes[n].parent) {
+        const QStringView name = m_names[m_nodes[n].name];
+        out -= name.size();
+        std::memcpy(out, name.data(), name.size() * sizeof(QChar));
+
+        if (sepBefore(n))
+            *--out = s_sep;
+    }
+
+    return result;
+}
+
+int PathTree::size() const
+{
+    return static_cast<int>(m_nodes.size());
+}
+
+int PathTree::nameCount() const
+{
+    return static_cast<int>(m_names.size());
+}
+
+void PathTree::reserve(int nodes)
+{
+    m_nodes.reserve(nodes);
+    m_childIndex.reserve(nodes);
+}
+
+qint64 PathTree::memoryUsage() const
+{
+    return qint64(m_nodes.capacity() * sizeof(Node))
+           + qint64(m_names.capacity() * sizeof(QStringView))
+           + m_namePool.size() * qint64(sizeof(char16_t))
+           + qint64(m_nameIndex.memoryUsage() + m_childIndex.memoryUsage())
+           + qint64(m_lastPath.capacity()) * qint64(sizeof(QChar))
+           + qint64((m_lastEnds.capacity() + m_lastNodes.capacity()) * sizeof(int));
+}
+
+int PathTree::internName(QStringView name)
+{
+    const quint32 hash = hashName(name);
+    const int found = findName(name, hash);
+
+    if (found != -1)
+        return found;
+
+    m_names.push_back(m_namePool.store(name));
+    m_nameIndex.insert(hash, nameCount() - 1);
+
+    return nameCount() - 1;
+}
+
+int PathTree::findName(QStringView name, quint32 hash) const
+{
+    return m_nameIndex.find(hash, [&](int index) { return m_names[index] == name; });
+}
+
+PathTree::Handle PathTree::addChild(Handle parent, QStringView name)
+{
+    const int nameInd = internName(name);
+    const quint32 hash = hashChild(parent, nameInd);
+    const Handle found = findChild(parent, nameInd, hash);
+
+    if (found != s_none)
+        return found;
+
+    m_nodes.push_back({ parent, nameInd, depth(parent) + 1 });
+    m_childIndex.insert(hash, size() - 1);
+
+    return size() - 1;
+}
+
+PathTree::Handle PathTree::findChild(Handle parent, int name, quint32 hash) const
+{
+    return m_childIndex.find(hash, [&](int index) {
+        const Node &node = m_nodes[index];
+        return node.parent == parent && node.name == name;
+    });
+}
+
+} // namespace pathstr
@@ -0,0 +1,109 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHTREE_H
+#define PATHTREE_H
+
+#include "hashtable_p.h"
+#include "pathbuilder.h"
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+namespace pathstr {
+/* Stores many paths as a tree of (parent, name) nodes, each distinct name is kept once.
+ * The paths are split at '/' (as in entryName()), the root ("/", "C:/") is the first
+ * component; empty components are skipped, so "/folder//file/" is stored as "/folder/file".
+ * The handles are stable integers, the nodes are never removed.
+ *
+ * PathTree tree;
+ * PathTree::Handle file = tree.insert(u"/home/folder/file.txt");
+ * tree.entryName(file)            -> "file.txt"
+ * tree.path(tree.parent(file))    -> "/home/folder"
+ * tree.relativePath(tree.find(u"/home"), file) -> "folder/file.txt"
+ */
+class PathTree
+{
+public:
+    typedef int Handle;
+    static constexpr Handle s_none = -1;
+
+    PathTree();
+
+    // Adds the <path> and its parent folders, returns the handle of the last component.
+    // The prefix shared with the previous insert is not looked up again, so sorted input is the fastest.
+    Handle insert(QStringView path);
+    QVector<Handle> insert(const QStringList &paths);
+
+    // Adds the <name> to the <parent> folder (s_none: a top level root or name), returns its handle
+    Handle insertChild(Handle parent, QStringView name);
+
+    // The handle of the <name> in the <parent> folder (s_none: the top level), s_none if not found
+    Handle child(Handle parent, QStringView name) const;
+
+    // The handle of the <path>, s_none if it was not inserted
+    Handle find(QStringView path) const;
+
+    // The components joined with '/': O(depth)
+    QString path(Handle node) const;
+
+    // The name of the node, the root node keeps its text: "/", "C:/"
+    QStringView entryName(Handle node) const;
+
+    // The parent folder node, s_none for the top level nodes
+    Handle parent(Handle node) const;
+
+    // The number of components: "/" -> 1, "/home/folder" -> 3
+    int depth(Handle node) const;
+
+    // true if the <node> is inside the <folder>: O(depth difference)
+    bool isAncestor(Handle folder, Handle node) const;
+
+    // The path of the <node> relative to the <folder>, a null string if it's not inside
+    QString relativePath(Handle folder, Handle node) const;
+
+    // The number of nodes, the number of distinct names
+    int size() const;
+    int nameCount() const;
+
+    void reserve(int nodes);
+
+    // The approximate number of bytes used
+    qint64 memoryUsage() const;
+
+private:
+    struct Node {
+        int parent; // node index, -1 for the top level
+        int name;   // index in m_names
+        int depth;
+    };
+
+    int internName(QStringView name);
+    int findName(QStringView name, quint32 hash) const;
+    Handle addChild(Handle parent, QStringView name);
+    Handle findChild(Handle parent, int name, quint32 hash) const;
+
+    std::vector<Node> m_nodes;
+    std::vector<QStringView> m_names;     // the name texts are in m_namePool
+    PathArena m_namePool;
+    core::detail::HashIndex m_nameIndex;  // of m_names
+    core::detail::HashIndex m_childIndex; // of m_nodes, keyed by (parent, name)
+
+    // the previous insert: the component ends and their nodes, reused by the next one
+    QString m_lastPath;
+    std::vector<int> m_lastEnds;
+    std::vector<Handle> m_lastNodes;
+};
+
+} // namespace pathstr
+
+#endif // PATHTREE_H
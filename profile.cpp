@@ -0,0 +1,318 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "profile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace pathstr {
+namespace profile {
+#define PATHSTR_PROFILE_NAME(name) #name,
+static const char *const s_functionNames[] = {
+    PATHSTR_PROFILE_FUNCTIONS(PATHSTR_PROFILE_NAME)
+};
+#undef PATHSTR_PROFILE_NAME
+
+static std::atomic<bool> s_enabled { true };
+static std::atomic<quint64 (*)()> s_allocationCounter { nullptr };
+
+const char *functionName(Function function)
+{
+    const int index = static_cast<int>(function);
+    return (index >= 0 && index < s_functionCount) ? s_functionNames[index] : "";
+}
+
+int sizeBucket(qint64 size)
+{
+    int bucket = 0;
+
+    while (size > 0 && bucket < s_sizeBuckets - 1) {
+        size >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+QByteArray sizeBucketName(int bucket)
+{
+    if (bucket <= 1)
+        return QByteArray::number(qMax(bucket, 0));
+
+    const qint64 from = qint64(1) << (bucket - 1);
+
+    if (bucket == s_sizeBuckets - 1)
+        return QByteArray::number(from) + '+';
+
+    return QByteArray::number(from) + '-' + QByteArray::number(2 * from - 1);
+}
+
+bool isAvailable()
+{
+#ifdef PATHSTR_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isEnabled()
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void setAllocationCounter(quint64 (*counter)())
+{
+    s_allocationCounter.store(counter, std::memory_order_relaxed);
+}
+
+/*** Snapshot ***/
+static void appendField(QByteArray &json, const char *name, quint64 value)
+{
+    json += ", \"";
+    json += name;
+    json += "\": ";
+    json += QByteArray::number(value);
+}
+
+QByteArray Snapshot::toJson() const
+{
+    QByteArray json = "{ \"sample_interval\": " + QByteArray::number(s_sampleInterval) + ", \"functions\": [";
+    bool first = true;
+
+    for (int i = 0; i < s_functionCount; ++i) {
+        const FunctionStats &stats = functions[i];
+        if (stats.calls == 0)
+            continue;
+
+        json += first ? "\n  { \"name\": \"" : ",\n  { \"name\": \"";
+        json += s_functionNames[i];
+        json += '"';
+        first = false;
+
+        appendField(json, "calls", stats.calls);
+        appendField(json, "allocations", stats.allocations);
+        appendField(json, "sampled_calls", stats.sampledCalls);
+        appendField(json, "sampled_ns", stats.sampledNanos);
+        appendField(json, "mean_ns", stats.meanNanos());
+        appendField(json, "max_ns", stats.maxNanos);
+
+        json += ", \"sizes\": {";
+        const char *sep = " ";
+        for (int bucket = 0; bucket < s_sizeBuckets; ++bucket) {
+            if (stats.sizes[bucket] == 0)
+                continue;
+
+            json += sep;
+            json += '"' + sizeBucketName(bucket) + "\": " + QByteArray::number(stats.sizes[bucket]);
+            sep = ", ";
+        }
+        json += " } }";
+    }
+
+    json += first ? "] }\n" : "\n] }\n";
+    return json;
+}
+
+#ifndef PATHSTR_PROFILE
+Snapshot snapshot()
+{
+    return Snapshot();
+}
+
+void reset()
+{}
+#else
+/*** Counters ***/
+// Added to by the owner thread, read and zeroed by any: reset() may run during an add()
+struct Counters
+{
+    std::atomic<quint64> calls { 0 };
+    std::atomic<quint64> allocations { 0 };
+    std::atomic<quint64> sampledCalls { 0 };
+    std::atomic<quint64> sampledNanos { 0 };
+    std::atomic<quint64> maxNanos { 0 };
+    std::atomic<quint64> sizes[s_sizeBuckets] = {};
+    unsigned tick = 0; // the calls until the next timed one, the owner thread only
+};
+
+// Atomic read-modify-write, so a concurrent reset() is not overwritten with the old sum;
+// the cache line is the owner's, the uncontended fetch_add stays cheap
+static inline void add(std::atomic<quint64> &counter, quint64 value)
+{
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+static inline void raise(std::atomic<quint64> &counter, quint64 value)
+{
+    quint64 current = counter.load(std::memory_order_relaxed);
+
+    while (value > current) {
+        if (counter.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            break;
+    }
+}
+
+static void addTo(FunctionStats &stats, const Counters &counters)
+{
+    stats.calls += counters.calls.load(std::memory_order_relaxed);
+    stats.allocations += counters.allocations.load(std::memory_order_relaxed);
+    stats.sampledCalls += counters.sampledCalls.load(std::memory_order_relaxed);
+    stats.sampledNanos += counters.sampledNanos.load(std::memory_order_relaxed);
+    stats.maxNanos = std::max(stats.maxNanos, counters.maxNanos.load(std::memory_order_relaxed));
+
+    for (int i = 0; i < s_sizeBuckets; ++i)
+        stats.sizes[i] += counters.sizes[i].load(std::memory_order_relaxed);
+}
+
+static void clear(Counters &counters)
+{
+    counters.calls.store(0, std::memory_order_relaxed);
+    counters.allocations.store(0, std::memory_order_relaxed);
+    counters.sampledCalls.store(0, std::memory_order_relaxed);
+    counters.sampledNanos.store(0, std::memory_order_relaxed);
+    counters.maxNanos.store(0, std::memory_order_relaxed);
+
+    for (std::atomic<quint64> &size : counters.sizes)
+        size.store(0, std::memory_order_relaxed);
+}
+
+struct ThreadCounters;
+
+// The counters of the running threads and the sums of the finished ones
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadCounters *> threads;
+    Snapshot finished;
+};
+
+// Never destroyed: the thread-local counters can outlive the static objects
+static Registry &registry()
+{
+    static Registry *const s_registry = new Registry;
+    return *s_registry;
+}
+
+struct ThreadCounters
+{
+    ThreadCounters()
+    {
+        Registry &reg = registry();
+        const std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.threads.push_back(this);
+    }
+
+    ~ThreadCounters()
+    {
+        Registry &reg = registry();
+        const std::lock_guard<std::mutex> lock(reg.mutex);
+
+        for (int i = 0; i < s_functionCount; ++i)
+            addTo(reg.finished.functions[i], functions[i]);
+
+        reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), this));
+    }
+
+    Counters functions[s_functionCount];
+};
+
+static thread_local int t_depth = 0;
+
+static ThreadCounters &threadCounters()
+{
+    static thread_local ThreadCounters t_counters;
+    return t_counters;
+}
+
+static inline qint64 nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Scope::enter(Function function, qint64 inputSize)
+{
+    if (t_depth++ > 0 || !s_enabled.load(std::memory_order_relaxed))
+        return;
+
+    Counters &counters = threadCounters().functions[static_cast<int>(function)];
+    m_counters = &counters;
+
+    add(counters.calls, 1);
+    add(counters.sizes[sizeBucket(inputSize)], 1);
+
+    m_allocationCounter = s_allocationCounter.load(std::memory_order_relaxed);
+    if (m_allocationCounter)
+        m_allocations = m_allocationCounter();
+
+    if (counters.tick-- == 0) {
+        counters.tick = s_sampleInterval - 1;
+        m_start = nowNanos();
+    }
+}
+
+void Scope::leave()
+{
+    --t_depth;
+
+    if (!m_counters)
+        return;
+
+    if (m_start != -1) {
+        const quint64 nanos = nowNanos() - m_start;
+        add(m_counters->sampledCalls, 1);
+        add(m_counters->sampledNanos, nanos);
+        raise(m_counters->maxNanos, nanos);
+    }
+
+    if (m_allocationCounter)
+        add(m_counters->allocations, m_allocationCounter() - m_allocations);
+}
+
+Snapshot snapshot()
+{
+    Registry &reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    Snapshot result = reg.finished;
+
+    for (const ThreadCounters *thread : reg.threads) {
+        for (int i = 0; i < s_functionCount; ++i)
+            addTo(result.functions[i], thread->functions[i]);
+    }
+
+    return result;
+}
+
+void reset()
+{
+    Registry &reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.finished = Snapshot();
+
+    for (ThreadCounters *thread : reg.threads) {
+        for (Counters &counters : thread->functions)
+            clear(counters);
+    }
+}
+#endif
+
+} // namespace profile
+} // namespace pathstr
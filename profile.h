@@ -0,0 +1,150 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/* Profiling of the pathstr.h functions, built with the PATHSTR_PROFILE option (CMake)
+ * or define. Per function: the number of calls, the histogram of the input sizes,
+ * the heap allocations and the duration of every s_sampleInterval-th call.
+ *
+ * The counters are thread-local, a snapshot() sums the ones of all threads
+ * (also of the finished ones). Only the outermost pathstr call is counted:
+ * normalize() calling isNormalized() is a single normalize() call. The calls made
+ * by the other classes of the library (PathGlob calling isSeparator()) are counted.
+ *
+ * profile::reset();
+ * ...
+ * profile::snapshot()[profile::Function::joinPath].calls -> 1000
+ * profile::snapshot().toJson()                           -> { "functions": [ ... ] }
+ *
+ * Without the option the PATHSTR_PROFILE_SCOPE expands to nothing, the functions
+ * below are available and the snapshots are empty.
+ */
+#define PATHSTR_PROFILE_FUNCTIONS(F) \
+    F(joinPath) F(entryName) F(baseName) F(parentFolder) F(relativePath) F(renameFile) \
+    F(composeFilePath) F(root) F(suffix) F(completeSuffix) F(setSuffix) F(suffixSize) \
+    F(completeSuffixSize) F(hasExtension) F(hasWindowsRoot) F(isRoot) F(isAbsolute) F(isRelative) \
+    F(isSeparator) F(endsWithSep) F(startsWithSep) F(appendSep) F(chopSep) \
+    F(appendSepInPlace) F(chopSepInPlace) F(setSuffixInPlace) F(joinPathInto) F(renameFileInPlace) \
+    F(entryNameView) F(baseNameView) F(parentFolderView) F(relativePathView) F(commonAncestorView) F(rootView) \
+    F(suffixView) F(completeSuffixView) F(lowerSuffixView) F(lowerCompleteSuffixView) \
+    F(normalize) F(isNormalized) F(joinStrings) F(comparePaths)
+
+namespace pathstr {
+namespace profile {
+#define PATHSTR_PROFILE_ENUM(name) name,
+enum class Function {
+    PATHSTR_PROFILE_FUNCTIONS(PATHSTR_PROFILE_ENUM)
+    Count
+};
+#undef PATHSTR_PROFILE_ENUM
+
+static const int s_functionCount = static_cast<int>(Function::Count);
+
+// Every 64th call of a function (per thread) is timed
+static const int s_sampleInterval = 64;
+
+// The input sizes: 0, 1, 2-3, 4-7, ..., 32768-65535, 65536 and more
+static const int s_sizeBuckets = 18;
+
+struct FunctionStats
+{
+    quint64 calls = 0;
+    quint64 allocations = 0;           // during the calls, counted if there is an allocation counter
+    quint64 sampledCalls = 0;          // the timed calls
+    quint64 sampledNanos = 0;          // their total duration
+    quint64 maxNanos = 0;              // the longest one
+    quint64 sizes[s_sizeBuckets] = {}; // the calls by the total size of the string arguments
+
+    quint64 meanNanos() const { return sampledCalls ? sampledNanos / sampledCalls : 0; }
+};
+
+struct Snapshot
+{
+    FunctionStats functions[s_functionCount];
+
+    const FunctionStats &operator[](Function function) const { return functions[static_cast<int>(function)]; }
+
+    /* { "sample_interval": 64, "functions": [ { "name": "joinPath", "calls": 1000, "allocations": 1000,
+     *   "sampled_calls": 15, "sampled_ns": 900, "mean_ns": 60, "max_ns": 150, "sizes": { "16-31": 1000 } } ] }
+     * The functions that were not called are omitted, as well as the empty size buckets.
+     */
+    QByteArray toJson() const;
+};
+
+// "joinPath"
+const char *functionName(Function function);
+
+// The bucket of the <size> in FunctionStats::sizes
+int sizeBucket(qint64 size);
+
+// "2-3", "65536+"
+QByteArray sizeBucketName(int bucket);
+
+// true if built with PATHSTR_PROFILE
+bool isAvailable();
+
+// Counting can be paused at run time (on by default)
+void setEnabled(bool enabled);
+bool isEnabled();
+
+/* The allocations are counted by an application provided <counter>: the number of
+ * heap allocations so far, e.g. from a malloc hook. A thread-local counter gives exact
+ * results, a global one also counts the allocations of other threads. nullptr: not counted.
+ */
+void setAllocationCounter(quint64 (*counter)());
+
+// The counters of all threads, summed
+Snapshot snapshot();
+
+// Zeroes the counters of all threads
+void reset();
+
+#ifdef PATHSTR_PROFILE
+struct Counters;
+
+// Counts the call from construction to destruction
+class Scope
+{
+public:
+    Scope(Function function, qint64 inputSize) { enter(function, inputSize); }
+    ~Scope() { leave(); }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    void enter(Function function, qint64 inputSize);
+    void leave();
+
+    Counters *m_counters = nullptr; // null if not counted: nested or disabled
+    quint64 (*m_allocationCounter)() = nullptr;
+    quint64 m_allocations = 0;
+    qint64 m_start = -1;            // ns, -1 if not timed
+};
+#endif
+
+} // namespace profile
+} // namespace pathstr
+
+#ifdef PATHSTR_PROFILE
+#define PATHSTR_PROFILE_SCOPE(function, inputSize) \
+    const ::pathstr::profile::Scope pathstrProfileScope(::pathstr::profile::Function::function, (inputSize))
+#else
+#define PATHSTR_PROFILE_SCOPE(function, inputSize)
+#endif
+
+#endif // PROFILE_H
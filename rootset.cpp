@@ -0,0 +1,122 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "rootset.h"
+
+namespace pathstr {
+static quint32 hashKey(QStringView key)
+{
+    return core::detail::hashUnits(key.utf16(), key.size());
+}
+
+RootSet::RootSet(const QStringList &rootFolders)
+{
+    m_roots.reserve(rootFolders.size());
+    m_keySizes.reserve(rootFolders.size());
+
+    for (const QString &rootFolder : rootFolders)
+        insert(rootFolder);
+}
+
+int RootSet::insert(const QString &rootFolder)
+{
+    if (rootFolder.isEmpty()) {
+        if (m_emptyRoot == -1) {
+            m_emptyRoot = size();
+            m_roots.append(rootFolder);
+            m_keySizes.push_back(-1); // never looked up
+        }
+        return m_emptyRoot;
+    }
+
+    // relativePath(): a single trailing '/' is not a part of the root
+    const int keySize = rootFolder.endsWith(s_sep) ? rootFolder.size() - 1 : rootFolder.size();
+    const QStringView rootKey = QStringView(rootFolder).left(keySize);
+    const quint32 hash = hashKey(rootKey);
+
+    const int found = findKey(rootKey, hash);
+    if (found != -1)
+        return found;
+
+    m_roots.append(rootFolder);
+    m_keySizes.push_back(keySize);
+    m_maxKeySize = qMax(m_maxKeySize, keySize);
+
+    if (keySize >= static_cast<int>(m_hasKeySize.size()))
+        m_hasKeySize.resize(keySize + 1);
+    m_hasKeySize[keySize] = true;
+
+    m_index.insert(hash, size() - 1);
+
+    return size() - 1;
+}
+
+int RootSet::find(QStringView path, QStringView *relative) const
+{
+    int found = m_emptyRoot;
+    int cut = -1; // the '/' after the found root
+
+    if (m_maxKeySize != -1) {
+        // the prefix before each '/' is a candidate, the last one found is the deepest
+        const char16_t *data = path.utf16();
+        const int limit = qMin(int(path.size()) - 1, m_maxKeySize);
+        quint32 hash = core::detail::s_fnvOffset;
+
+        for (int i = 0; i <= limit; ++i) {
+            if (data[i] == u'/' && m_hasKeySize[i]) {
+                const int index = findKey(path.left(i), hash);
+                if (index != -1) {
+                    found = index;
+                    cut = i;
+                }
+            }
+
+            hash = core::detail::hashStep(hash, data[i]);
+        }
+    }
+
+    if (relative) {
+        if (found == -1)
+            *relative = QStringView();
+        else
+            *relative = (cut == -1) ? path : path.mid(cut + 1);
+    }
+
+    return found;
+}
+
+QString RootSet::root(int index) const
+{
+    return (index < 0 || index >= size()) ? QString() : m_roots.at(index);
+}
+
+int RootSet::size() const
+{
+    return m_roots.size();
+}
+
+bool RootSet::isEmpty() const
+{
+    return m_roots.isEmpty();
+}
+
+QStringView RootSet::key(int index) const
+{
+    return QStringView(m_roots.at(index)).left(m_keySizes[index]);
+}
+
+int RootSet::findKey(QStringView key, quint32 hash) const
+{
+    return m_index.find(hash, [&](int index) { return this->key(index) == key; });
+}
+
+} // namespace pathstr
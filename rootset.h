@@ -0,0 +1,67 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef ROOTSET_H
+#define ROOTSET_H
+
+#include "hashtable_p.h"
+#include "pathstr.h"
+#include <QStringList>
+#include <vector>
+
+namespace pathstr {
+/* A set of root folders, indexed for finding the deepest one containing a path.
+ * The roots are matched as in relativePath(): "/folder/" and "/folder" are the same root,
+ * an empty root contains every path. A lookup hashes the path prefixes ending at '/'
+ * in a single pass, so it takes O(path size) regardless of the number of roots.
+ *
+ * const RootSet roots({ "/home/user", "/home/user/projects/", "/srv" });
+ * QStringView rel;
+ * roots.find(u"/home/user/projects/pathstr/README.md", &rel) -> 1, rel: "pathstr/README.md"
+ * roots.find(u"/home/user/file.txt", &rel)                   -> 0, rel: "file.txt"
+ * roots.find(u"/etc/hosts", &rel)                            -> -1, rel: null
+ */
+class RootSet
+{
+public:
+    RootSet() = default;
+    explicit RootSet(const QStringList &rootFolders);
+
+    // Adds the <rootFolder>, returns its index. The index of the same root is returned if it's already added.
+    int insert(const QString &rootFolder);
+
+    /* The index of the deepest root folder containing the <path>, -1 if there is none.
+     * The <relative> is set to relativePath(root(index), path), a view into the <path>.
+     */
+    int find(QStringView path, QStringView *relative = nullptr) const;
+
+    // The root folder as it was added
+    QString root(int index) const;
+
+    int size() const;
+    bool isEmpty() const;
+
+private:
+    QStringView key(int index) const;
+    int findKey(QStringView key, quint32 hash) const;
+
+    QStringList m_roots;
+    std::vector<int> m_keySizes;     // the root without the trailing '/'
+    core::detail::HashIndex m_index; // of the keys, the empty root is not in it
+    std::vector<bool> m_hasKeySize;  // the prefixes of other sizes are not looked up
+    int m_maxKeySize = -1;
+    int m_emptyRoot = -1;            // the index of the empty root, if any
+};
+
+} // namespace pathstr
+
+#endif // ROOTSET_H
@@ -0,0 +1,595 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "simd.h"
+#include "casefold_p.h"
+#include <cstdint>
+
+#if !defined(PATHSTR_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+#define PATHSTR_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define PATHSTR_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace pathstr {
+namespace simd {
+namespace {
+typedef int (*ScanBackFn)(const char16_t *, int, char16_t, char16_t, char16_t, int *);
+typedef int (*LastIndexOfFn)(const char16_t *, int, char16_t, char16_t);
+typedef int (*MismatchFn)(const char16_t *, const char16_t *, int);
+typedef int (*ScanBack8Fn)(const char *, int, char, char, char, int *);
+typedef int (*LastIndexOf8Fn)(const char *, int, char, char);
+typedef int (*LowerAsciiFn)(const char16_t *, char16_t *, int);
+typedef int (*EqualsAsciiNoCaseFn)(const char16_t *, const char16_t *, int);
+
+struct Kernels
+{
+    ScanBackFn scanBack;
+    LastIndexOfFn lastIndexOf;
+    MismatchFn mismatch;
+    ScanBack8Fn scanBack8;
+    LastIndexOf8Fn lastIndexOf8;
+    LowerAsciiFn lowerAscii;
+    EqualsAsciiNoCaseFn equalsAsciiNoCase;
+    const char *name;
+};
+
+/*** Scalar ***/
+template <typename Char>
+int scanBackFrom(const Char *data, int i, Char sep, Char altSep, Char dot, int dots[3], int dotCount)
+{
+    for (--i; i >= 0; --i) {
+        const Char ch = data[i];
+
+        if (ch == sep || ch == altSep)
+            return i;
+
+        if (ch == dot && dotCount < 3)
+            dots[dotCount++] = i;
+    }
+
+    return -1;
+}
+
+template <typename Char>
+int lastIndexOfFrom(const Char *data, int i, Char ch, Char altCh)
+{
+    for (--i; i >= 0; --i) {
+        if (data[i] == ch || data[i] == altCh)
+            return i;
+    }
+
+    return -1;
+}
+
+int mismatchFrom(const char16_t *str1, const char16_t *str2, int i, int size)
+{
+    while (i < size && str1[i] == str2[i])
+        ++i;
+
+    return i;
+}
+
+int lowerAsciiFrom(const char16_t *src, char16_t *dst, int i, int size, int nonAscii)
+{
+    for (; i < size; ++i) {
+        if (src[i] > 0x7F && nonAscii == size)
+            nonAscii = i;
+        dst[i] = core::detail::foldAscii(src[i]);
+    }
+
+    return nonAscii;
+}
+
+int equalsAsciiNoCaseFrom(const char16_t *str1, const char16_t *str2, int i, int size, bool nonAscii)
+{
+    for (; i < size; ++i) {
+        if ((str1[i] | str2[i]) > 0x7F)
+            nonAscii = true;
+        else if (core::detail::foldAscii(str1[i]) != core::detail::foldAscii(str2[i]))
+            return 0;
+    }
+
+    return nonAscii ? -1 : 1;
+}
+
+#ifndef PATHSTR_SSE2
+int scanBackScalar(const char16_t *data, int end, char16_t sep, char16_t altSep, char16_t dot, int dots[3])
+{
+    return scanBackFrom(data, end, sep, altSep, dot, dots, 0);
+}
+
+int lastIndexOfScalar(const char16_t *data, int size, char16_t ch, char16_t altCh)
+{
+    return lastIndexOfFrom(data, size, ch, altCh);
+}
+
+int mismatchScalar(const char16_t *str1, const char16_t *str2, int size)
+{
+    return mismatchFrom(str1, str2, 0, size);
+}
+
+int scanBack8Scalar(const char *data, int end, char sep, char altSep, char dot, int dots[3])
+{
+    return scanBackFrom(data, end, sep, altSep, dot, dots, 0);
+}
+
+int lastIndexOf8Scalar(const char *data, int size, char ch, char altCh)
+{
+    return lastIndexOfFrom(data, size, ch, altCh);
+}
+
+int lowerAsciiScalar(const char16_t *src, char16_t *dst, int size)
+{
+    return lowerAsciiFrom(src, dst, 0, size, size);
+}
+
+int equalsAsciiNoCaseScalar(const char16_t *str1, const char16_t *str2, int size)
+{
+    return equalsAsciiNoCaseFrom(str1, str2, 0, size, false);
+}
+#endif
+
+#ifdef PATHSTR_SSE2
+/* The masks come from movemask_epi8: 2 bits per code unit over the 16-bit compares
+ * (Shift = 1, the unit index within the block is the bit index / 2), 1 bit per byte
+ * over the 8-bit ones (Shift = 0).
+ */
+inline int highestBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long ind;
+    _BitScanReverse64(&ind, mask);
+    return static_cast<int>(ind);
+#else
+    return 63 - __builtin_clzll(mask);
+#endif
+}
+
+inline int lowestBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long ind;
+    _BitScanForward64(&ind, mask);
+    return static_cast<int>(ind);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Takes the dots of the block from the highest one
+template <int Shift>
+inline void collectDots(uint64_t dotMask, int base, int dots[3], int &dotCount)
+{
+    while (dotMask && dotCount < 3) {
+        const int unit = highestBit(dotMask) >> Shift;
+        dots[dotCount++] = base + unit;
+        dotMask &= ~(((uint64_t(1) << (1 << Shift)) - 1) << (unit << Shift));
+    }
+}
+
+// Keeps the bits of the units above the <unit>
+template <int Shift>
+inline uint64_t bitsAbove(uint64_t mask, int unit)
+{
+    return mask & ~((uint64_t(1) << ((unit + 1) << Shift)) - 1);
+}
+
+int scanBackSse2(const char16_t *data, int end, char16_t sep, char16_t altSep, char16_t dot, int dots[3])
+{
+    const __m128i vSep = _mm_set1_epi16(static_cast<short>(sep));
+    const __m128i vAlt = _mm_set1_epi16(static_cast<short>(altSep));
+    const __m128i vDot = _mm_set1_epi16(static_cast<short>(dot));
+    int dotCount = 0;
+    int i = end;
+
+    while (i >= 8) {
+        i -= 8;
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const uint64_t sepMask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi16(v, vSep), _mm_cmpeq_epi16(v, vAlt))));
+        uint64_t dotMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, vDot)));
+
+        if (sepMask) {
+            const int unit = highestBit(sepMask) >> 1;
+            collectDots<1>(bitsAbove<1>(dotMask, unit), i, dots, dotCount);
+            return i + unit;
+        }
+
+        collectDots<1>(dotMask, i, dots, dotCount);
+    }
+
+    return scanBackFrom(data, i, sep, altSep, dot, dots, dotCount);
+}
+
+int lastIndexOfSse2(const char16_t *data, int size, char16_t ch, char16_t altCh)
+{
+    const __m128i vCh = _mm_set1_epi16(static_cast<short>(ch));
+    const __m128i vAlt = _mm_set1_epi16(static_cast<short>(altCh));
+    int i = size;
+
+    while (i >= 8) {
+        i -= 8;
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const uint64_t mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi16(v, vCh), _mm_cmpeq_epi16(v, vAlt))));
+
+        if (mask)
+            return i + (highestBit(mask) >> 1);
+    }
+
+    return lastIndexOfFrom(data, i, ch, altCh);
+}
+
+int mismatchSse2(const char16_t *str1, const char16_t *str2, int size)
+{
+    int i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str1 + i));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str2 + i));
+        const unsigned eq = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(v1, v2)));
+
+        if (eq != 0xFFFF)
+            return i + (lowestBit(~eq & 0xFFFF) >> 1);
+    }
+
+    return mismatchFrom(str1, str2, i, size);
+}
+
+int scanBack8Sse2(const char *data, int end, char sep, char altSep, char dot, int dots[3])
+{
+    const __m128i vSep = _mm_set1_epi8(sep);
+    const __m128i vAlt = _mm_set1_epi8(altSep);
+    const __m128i vDot = _mm_set1_epi8(dot);
+    int dotCount = 0;
+    int i = end;
+
+    while (i >= 16) {
+        i -= 16;
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const uint64_t sepMask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, vSep), _mm_cmpeq_epi8(v, vAlt))));
+        const uint64_t dotMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, vDot)));
+
+        if (sepMask) {
+            const int unit = highestBit(sepMask);
+            collectDots<0>(bitsAbove<0>(dotMask, unit), i, dots, dotCount);
+            return i + unit;
+        }
+
+        collectDots<0>(dotMask, i, dots, dotCount);
+    }
+
+    return scanBackFrom(data, i, sep, altSep, dot, dots, dotCount);
+}
+
+int lastIndexOf8Sse2(const char *data, int size, char ch, char altCh)
+{
+    const __m128i vCh = _mm_set1_epi8(ch);
+    const __m128i vAlt = _mm_set1_epi8(altCh);
+    int i = size;
+
+    while (i >= 16) {
+        i -= 16;
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const uint64_t mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, vCh), _mm_cmpeq_epi8(v, vAlt))));
+
+        if (mask)
+            return i + highestBit(mask);
+    }
+
+    return lastIndexOfFrom(data, i, ch, altCh);
+}
+
+// 'A'-'Z' lowered; the signed compares keep the units above 0x7FFF as they are
+inline __m128i lowerSse2(__m128i v)
+{
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16('A' - 1)),
+                                        _mm_cmplt_epi16(v, _mm_set1_epi16('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+}
+
+// The mask of the non-ASCII units
+inline unsigned nonAsciiSse2(__m128i v)
+{
+    const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(short(0xFF80))), _mm_setzero_si128());
+    return ~static_cast<unsigned>(_mm_movemask_epi8(ascii)) & 0xFFFF;
+}
+
+int lowerAsciiSse2(const char16_t *src, char16_t *dst, int size)
+{
+    int nonAscii = size;
+    int i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const unsigned mask = nonAsciiSse2(v);
+
+        if (mask && nonAscii == size)
+            nonAscii = i + (lowestBit(mask) >> 1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), lowerSse2(v));
+    }
+
+    return lowerAsciiFrom(src, dst, i, size, nonAscii);
+}
+
+int equalsAsciiNoCaseSse2(const char16_t *str1, const char16_t *str2, int size)
+{
+    bool nonAscii = false;
+    int i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str1 + i));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(str2 + i));
+        const unsigned other = nonAsciiSse2(_mm_or_si128(v1, v2));
+        const unsigned eq = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(lowerSse2(v1), lowerSse2(v2))));
+
+        // a difference of ASCII units is final
+        if (~(eq | other) & 0xFFFF)
+            return 0;
+
+        nonAscii |= (other != 0);
+    }
+
+    return equalsAsciiNoCaseFrom(str1, str2, i, size, nonAscii);
+}
+#endif // PATHSTR_SSE2
+
+#ifdef PATHSTR_AVX2
+__attribute__((target("avx2")))
+int scanBackAvx2(const char16_t *data, int end, char16_t sep, char16_t altSep, char16_t dot, int dots[3])
+{
+    const __m256i vSep = _mm256_set1_epi16(static_cast<short>(sep));
+    const __m256i vAlt = _mm256_set1_epi16(static_cast<short>(altSep));
+    const __m256i vDot = _mm256_set1_epi16(static_cast<short>(dot));
+    int dotCount = 0;
+    int i = end;
+
+    while (i >= 16) {
+        i -= 16;
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const uint64_t sepMask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi16(v, vSep), _mm256_cmpeq_epi16(v, vAlt))));
+        uint64_t dotMask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, vDot)));
+
+        if (sepMask) {
+            const int unit = highestBit(sepMask) >> 1;
+            collectDots<1>(bitsAbove<1>(dotMask, unit), i, dots, dotCount);
+            return i + unit;
+        }
+
+        collectDots<1>(dotMask, i, dots, dotCount);
+    }
+
+    return scanBackFrom(data, i, sep, altSep, dot, dots, dotCount);
+}
+
+__attribute__((target("avx2")))
+int lastIndexOfAvx2(const char16_t *data, int size, char16_t ch, char16_t altCh)
+{
+    const __m256i vCh = _mm256_set1_epi16(static_cast<short>(ch));
+    const __m256i vAlt = _mm256_set1_epi16(static_cast<short>(altCh));
+    int i = size;
+
+    while (i >= 16) {
+        i -= 16;
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const uint64_t mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi16(v, vCh), _mm256_cmpeq_epi16(v, vAlt))));
+
+        if (mask)
+            return i + (highestBit(mask) >> 1);
+    }
+
+    return lastIndexOfFrom(data, i, ch, altCh);
+}
+
+__attribute__((target("avx2")))
+int mismatchAvx2(const char16_t *str1, const char16_t *str2, int size)
+{
+    int i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str1 + i));
+        const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str2 + i));
+        const unsigned eq = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v1, v2)));
+
+        if (eq != 0xFFFFFFFFu)
+            return i + (lowestBit(~eq) >> 1);
+    }
+
+    return mismatchFrom(str1, str2, i, size);
+}
+
+__attribute__((target("avx2")))
+int scanBack8Avx2(const char *data, int end, char sep, char altSep, char dot, int dots[3])
+{
+    const __m256i vSep = _mm256_set1_epi8(sep);
+    const __m256i vAlt = _mm256_set1_epi8(altSep);
+    const __m256i vDot = _mm256_set1_epi8(dot);
+    int dotCount = 0;
+    int i = end;
+
+    while (i >= 32) {
+        i -= 32;
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const uint64_t sepMask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, vSep), _mm256_cmpeq_epi8(v, vAlt))));
+        const uint64_t dotMask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, vDot)));
+
+        if (sepMask) {
+            const int unit = highestBit(sepMask);
+            collectDots<0>(bitsAbove<0>(dotMask, unit), i, dots, dotCount);
+            return i + unit;
+        }
+
+        collectDots<0>(dotMask, i, dots, dotCount);
+    }
+
+    return scanBackFrom(data, i, sep, altSep, dot, dots, dotCount);
+}
+
+__attribute__((target("avx2")))
+int lastIndexOf8Avx2(const char *data, int size, char ch, char altCh)
+{
+    const __m256i vCh = _mm256_set1_epi8(ch);
+    const __m256i vAlt = _mm256_set1_epi8(altCh);
+    int i = size;
+
+    while (i >= 32) {
+        i -= 32;
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const uint64_t mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, vCh), _mm256_cmpeq_epi8(v, vAlt))));
+
+        if (mask)
+            return i + highestBit(mask);
+    }
+
+    return lastIndexOfFrom(data, i, ch, altCh);
+}
+
+__attribute__((target("avx2")))
+inline __m256i lowerAvx2(__m256i v)
+{
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi16(v, _mm256_set1_epi16('A' - 1)),
+                                           _mm256_cmpgt_epi16(_mm256_set1_epi16('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi16(0x20)));
+}
+
+__attribute__((target("avx2")))
+inline unsigned nonAsciiAvx2(__m256i v)
+{
+    const __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(v, _mm256_set1_epi16(short(0xFF80))), _mm256_setzero_si256());
+    return ~static_cast<unsigned>(_mm256_movemask_epi8(ascii));
+}
+
+__attribute__((target("avx2")))
+int lowerAsciiAvx2(const char16_t *src, char16_t *dst, int size)
+{
+    int nonAscii = size;
+    int i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const unsigned mask = nonAsciiAvx2(v);
+
+        if (mask && nonAscii == size)
+            nonAscii = i + (lowestBit(mask) >> 1);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), lowerAvx2(v));
+    }
+
+    return lowerAsciiFrom(src, dst, i, size, nonAscii);
+}
+
+__attribute__((target("avx2")))
+int equalsAsciiNoCaseAvx2(const char16_t *str1, const char16_t *str2, int size)
+{
+    bool nonAscii = false;
+    int i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str1 + i));
+        const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str2 + i));
+        const unsigned other = nonAsciiAvx2(_mm256_or_si256(v1, v2));
+        const unsigned eq = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(lowerAvx2(v1), lowerAvx2(v2))));
+
+        if (~(eq | other))
+            return 0;
+
+        nonAscii |= (other != 0);
+    }
+
+    return equalsAsciiNoCaseFrom(str1, str2, i, size, nonAscii);
+}
+#endif // PATHSTR_AVX2
+
+Kernels detect()
+{
+#ifdef PATHSTR_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return { scanBackAvx2, lastIndexOfAvx2, mismatchAvx2, scanBack8Avx2, lastIndexOf8Avx2,
+                 lowerAsciiAvx2, equalsAsciiNoCaseAvx2, "avx2" };
+#endif
+
+#ifdef PATHSTR_SSE2
+    return { scanBackSse2, lastIndexOfSse2, mismatchSse2, scanBack8Sse2, lastIndexOf8Sse2,
+             lowerAsciiSse2, equalsAsciiNoCaseSse2, "sse2" };
+#else
+    return { scanBackScalar, lastIndexOfScalar, mismatchScalar, scanBack8Scalar, lastIndexOf8Scalar,
+             lowerAsciiScalar, equalsAsciiNoCaseScalar, "scalar" };
+#endif
+}
+
+const Kernels &kernels()
+{
+    static const Kernels s_kernels = detect();
+    return s_kernels;
+}
+} // namespace
+
+int scanBack(const char16_t *data, int end, char16_t sep, char16_t altSep, char16_t dot, int dots[3])
+{
+    dots[0] = dots[1] = dots[2] = -1;
+    return kernels().scanBack(data, end, sep, altSep, dot, dots);
+}
+
+int lastIndexOf(const char16_t *data, int size, char16_t ch, char16_t altCh)
+{
+    return kernels().lastIndexOf(data, size, ch, altCh);
+}
+
+int mismatch(const char16_t *str1, const char16_t *str2, int size)
+{
+    return kernels().mismatch(str1, str2, size);
+}
+
+int scanBack(const char *data, int end, char sep, char altSep, char dot, int dots[3])
+{
+    dots[0] = dots[1] = dots[2] = -1;
+    return kernels().scanBack8(data, end, sep, altSep, dot, dots);
+}
+
+int lastIndexOf(const char *data, int size, char ch, char altCh)
+{
+    return kernels().lastIndexOf8(data, size, ch, altCh);
+}
+
+int lowerAscii(const char16_t *src, char16_t *dst, int size)
+{
+    return kernels().lowerAscii(src, dst, size);
+}
+
+int equalsAsciiNoCase(const char16_t *str1, const char16_t *str2, int size)
+{
+    return kernels().equalsAsciiNoCase(str1, str2, size);
+}
+
+const char *backend()
+{
+    return kernels().name;
+}
+
+} // namespace simd
+} // namespace pathstr
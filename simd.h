@@ -0,0 +1,57 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef PATHSTR_SIMD_H
+#define PATHSTR_SIMD_H
+
+namespace pathstr {
+namespace simd {
+/* Scanning kernels over UTF-16 code units and bytes (UTF-8).
+ * The implementation is selected at runtime: AVX2 or SSE2 on x86-64, scalar elsewhere
+ * (or when built with PATHSTR_NO_SIMD). All of them give the same results.
+ */
+
+/* Scans <data>[0, end) backwards up to the first <sep> or <altSep> (pass the same value twice
+ * for a single separator). Up to 3 positions of <dot> found after it are stored in <dots>,
+ * the last one first; the unused items are set to -1.
+ * Returns the index of the separator, or -1 if there is none.
+ */
+int scanBack(const char16_t *data, int end, char16_t sep, char16_t altSep, char16_t dot, int dots[3]);
+
+// The last index of <ch> or <altCh> in <data>[0, size), or -1
+int lastIndexOf(const char16_t *data, int size, char16_t ch, char16_t altCh);
+
+// The index of the first code unit that differs in <str1> and <str2>, or <size> if they are equal
+int mismatch(const char16_t *str1, const char16_t *str2, int size);
+
+/* Writes <src>[0, size) to <dst> (may be the same) with 'A'-'Z' lowered. Returns the index
+ * of the first non-ASCII code unit, or <size> if there is none: only then the result is
+ * the same as QString::toLower() gives.
+ */
+int lowerAscii(const char16_t *src, char16_t *dst, int size);
+
+/* Compares <str1> and <str2> with the ASCII letters case-folded: 1 if they are equal, 0 if they
+ * differ where both code units are ASCII, else -1: the Unicode case folding has to decide.
+ */
+int equalsAsciiNoCase(const char16_t *str1, const char16_t *str2, int size);
+
+// The same over bytes
+int scanBack(const char *data, int end, char sep, char altSep, char dot, int dots[3]);
+int lastIndexOf(const char *data, int size, char ch, char altCh);
+
+// The name of the selected implementation: "avx2", "sse2" or "scalar"
+const char *backend();
+
+} // namespace simd
+} // namespace pathstr
+
+#endif // PATHSTR_SIMD_H
@@ -1,6 +1,28 @@
 #include <QtTest/QTest>
+#include <QTemporaryDir>
 
 #include "pathstr.h"
+#include "extensionset.h"
+#include "pathinfo.h"
+#include "simd.h"
+#include "pathbuilder.h"
+#include "pathbuffer.h"
+#include "aggregate.h"
+#include "batch.h"
+#include "pathlist.h"
+#include "pathtree.h"
+#include "pathglob.h"
+#include "rootset.h"
+#include "pathkey.h"
+#include "profile.h"
+#include "walk.h"
+#include <QDir>
+#include <QHash>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
 
 class test_pathstr : public QObject
 {
@@ -32,6 +54,47 @@ private slots:
     void test_startsWithSep();
     void test_appendSep();
     void test_chopSep();
+    void test_entryNameView();
+    void test_baseNameView();
+    void test_parentFolderView();
+    void test_relativePathView();
+    void test_rootView();
+    void test_suffixView();
+    void test_completeSuffixView();
+    void test_lowerSuffixView();
+    void test_ExtensionSet();
+    void test_PathInfo();
+    void test_PathComponents();
+    void test_simd();
+    void test_PathBuilder();
+    void test_PathArena();
+    void test_relativePaths();
+    void test_setSuffixes();
+    void test_renameFiles();
+    void test_filterByExtension();
+    void test_coreUtf8();
+    void test_coreUtf16();
+    void test_corePolicies();
+    void test_MappedPathList();
+    void test_PathListWriter();
+    void test_pathListOperations();
+    void test_PathTree();
+    void test_normalize();
+    void test_isNormalized();
+    void test_PathGlob();
+    void test_filterByGlob();
+    void test_RootSet();
+    void test_relativePathsRootSet();
+    void test_comparePaths();
+    void test_diffSnapshots();
+    void test_sortPaths();
+    void test_PathKey();
+    void test_PathSet();
+    void test_profile();
+    void test_walk();
+    void test_commonAncestor();
+    void test_PathBuffer();
+    void test_PathAggregator();
 };
 
 test_pathstr::test_pathstr() {}
@@ -81,6 +144,35 @@ void test_pathstr::test_joinPath()
     QCOMPARE(joinPath("/home/folder/", "\\folder2\\file"), "/home/folder\\folder2\\file");
     QCOMPARE(joinPath("C:\\folder\\", "\\folder2\\file"), "C:\\folder\\folder2\\file");
     QCOMPARE(joinPath("C:\\folder\\", "/folder2/file"), "C:\\folder/folder2/file");
+
+    // in place, the same results
+    for (const QString &add : QStringList { "file", "/file", "\\file", "" }) {
+        for (const QString &dst : QStringList { "/home", "/home/", "C:\\", "" }) {
+            QString into = dst;
+            joinPathInto(into, add);
+            QCOMPARE(into, joinPath(dst, add));
+            QCOMPARE(joinPath(QString(dst), add), joinPath(dst, add));
+        }
+    }
+
+    // the spare capacity is reused
+    QString path = QStringLiteral(u"/home/folder");
+    path.reserve(64);
+    const QChar *data = path.constData();
+    joinPathInto(path, u"folder2");
+    joinPathInto(path, u"/file");
+    QCOMPARE(path, "/home/folder/folder2/file");
+    QVERIFY(path.constData() == data);
+
+    path = joinPath(std::move(path), QStringLiteral(u"next"));
+    QVERIFY(path.constData() == data);
+
+    // the shared data is detached
+    const QString shared = QStringLiteral(u"/shared");
+    QString copy = shared;
+    joinPathInto(copy, u"file");
+    QCOMPARE(shared, "/shared");
+    QCOMPARE(copy, "/shared/file");
 }
 
 void test_pathstr::test_composeFilePath()
@@ -100,6 +192,27 @@ void test_pathstr::test_renameFile()
     QCOMPARE(renameFile("/folder/archive.tar.gz", "new_name"), "/folder/new_name.tar.gz");
     QCOMPARE(renameFile("folder/archive.tar.gz", "new_name.tar.gz"), "folder/new_name.tar.gz");
     QCOMPARE(renameFile("folder/.file", "new_name"), "folder/new_name");
+
+    // in place, the same results
+    const QStringList names { "file.docx", "file_name", "/folder/archive.tar.gz", "folder/archive.TAR.GZ",
+                              "folder/.file", "/folder/file.txt/", "C:/file.Txt", "C:file.txt", "/", "C:/",
+                              "file..gz", "/folder/файл.ÄÖ" };
+    const QStringList newNames { "new_name", "new_name.tar.gz", "n", "a_much_longer_new_name.txt", "/name", "" };
+
+    for (const QString &oldName : names) {
+        for (const QString &newName : newNames) {
+            QString path = oldName;
+            renameFileInPlace(path, newName);
+            QCOMPARE(path, renameFile(oldName, newName));
+        }
+    }
+
+    QString path = QStringLiteral(u"/folder/archive.TAR.GZ");
+    path.reserve(64);
+    const QChar *data = path.constData();
+    path = renameFile(std::move(path), QStringLiteral(u"new"));
+    QCOMPARE(path, "/folder/new.tar.gz");
+    QVERIFY(path.constData() == data);
 }
 
 void test_pathstr::test_root()
@@ -117,6 +230,8 @@ void test_pathstr::test_suffix()
     QCOMPARE(suffix("file.txt"), "txt");
     QCOMPARE(suffix("file.ver.json"), "json");
     QCOMPARE(suffix(".hidden_file"), "");
+    QCOMPARE(suffix("file.TXT"), "txt");
+    QCOMPARE(suffix("file.TXT", false), "TXT");
 }
 
 void test_pathstr::test_completeSuffix()
@@ -134,6 +249,8 @@ void test_pathstr::test_completeSuffix()
     QVERIFY(completeSuffix("folder/.1").isEmpty());
     QVERIFY(completeSuffix("folder/1.").isNull());
     QVERIFY(completeSuffix("f.").isNull());
+    QCOMPARE(completeSuffix("archive.Tar.GZ"), "tar.gz");
+    QCOMPARE(completeSuffix("archive.Tar.GZ", false), "Tar.GZ");
 }
 
 void test_pathstr::test_setSuffix()
@@ -142,6 +259,22 @@ void test_pathstr::test_setSuffix()
     QCOMPARE(setSuffix("file.txt", "cpp"), "file.cpp");
     QCOMPARE(setSuffix("file.ver.json", "json"), "file.ver.json");
     QCOMPARE(setSuffix(".hidden", "txt"), ".hidden.txt");
+
+    // in place, the same results
+    for (const QString &suf : QStringList { "cpp", ".cpp", "", "longer_suffix" }) {
+        for (const QString &fileName : QStringList { "file.txt", "file.", "file", ".hidden", "/folder/file.ver.json", "" }) {
+            QString path = fileName;
+            setSuffixInPlace(path, suf);
+            QCOMPARE(path, setSuffix(fileName, suf));
+        }
+    }
+
+    QString path = QStringLiteral(u"/folder/file.txt");
+    path.reserve(64);
+    const QChar *data = path.constData();
+    path = setSuffix(std::move(path), QStringLiteral(u"cpp"));
+    QCOMPARE(path, "/folder/file.cpp");
+    QVERIFY(path.constData() == data);
 }
 
 void test_pathstr::test_suffixSize()
@@ -233,6 +366,11 @@ void test_pathstr::test_appendSep()
 {
     QCOMPARE(pathstr::appendSep("fooFolder"), "fooFolder/");
     QCOMPARE(pathstr::appendSep("fooFolder/"), "fooFolder/");
+
+    QString path = QStringLiteral(u"fooFolder");
+    pathstr::appendSepInPlace(path);
+    pathstr::appendSepInPlace(path);
+    QCOMPARE(path, "fooFolder/");
 }
 
 void test_pathstr::test_chopSep()
@@ -241,6 +379,1592 @@ void test_pathstr::test_chopSep()
     QCOMPARE(chopSep("fooPath/"), "fooPath");
     QCOMPARE(chopSep("fooPath\\"), "fooPath");
     QCOMPARE(chopSep("fooPath"), "fooPath");
+
+    QString path = QStringLiteral(u"fooPath\\");
+    path.reserve(64);
+    const QChar *data = path.constData();
+    chopSepInPlace(path);
+    chopSepInPlace(path);
+    QCOMPARE(path, "fooPath");
+    QVERIFY(chopSep(std::move(path)).constData() == data);
+}
+
+void test_pathstr::test_entryNameView()
+{
+    using namespace pathstr;
+    QCOMPARE(entryNameView(u"/folder/file.txt"), u"file.txt");
+    QCOMPARE(entryNameView(u"/folder/folder2/"), u"folder2");
+    QCOMPARE(entryNameView(u"folder2/"), u"folder2");
+    QVERIFY(entryNameView(u"/").isEmpty());
+    QVERIFY(entryNameView(u"C:/").isEmpty());
+
+    const QString path = "/folder/file.txt";
+    QCOMPARE(entryNameView(path).data(), path.constData() + 8);
+}
+
+void test_pathstr::test_baseNameView()
+{
+    using namespace pathstr;
+    QCOMPARE(baseNameView(u"/folder/archive.tar.gz"), u"archive");
+    QCOMPARE(baseNameView(u"/folder.name/.archive.zip"), u".archive");
+    QCOMPARE(baseNameView(u"folder/"), u"folder");
+}
+
+void test_pathstr::test_parentFolderView()
+{
+    using namespace pathstr;
+    QCOMPARE(parentFolderView(u"/folder/file_or_folder2"), u"/folder");
+    QCOMPARE(parentFolderView(u"/folder/file_or_folder2/"), u"/folder");
+    QCOMPARE(parentFolderView(u"/folder"), u"/");
+    QCOMPARE(parentFolderView(u"C:/folder"), u"C:/");
+    QCOMPARE(parentFolderView(u"C:/"), u"C:/");
+    QVERIFY(parentFolderView(u"folder/").isNull());
+}
+
+void test_pathstr::test_relativePathView()
+{
+    using namespace pathstr;
+    QCOMPARE(relativePathView(u"/folder/rootFolder", u"/folder/rootFolder/folder2/file"), u"folder2/file");
+    QCOMPARE(relativePathView(u"/folder/rootFolder/", u"/folder/rootFolder/folder2/file"), u"folder2/file");
+    QVERIFY(relativePathView(u"/folder/root", u"/folder/rootFolder/file").isNull());
+    QVERIFY(relativePathView(u"/rootFolder", u"/rootFolder/").isEmpty());
+}
+
+void test_pathstr::test_rootView()
+{
+    using namespace pathstr;
+    QCOMPARE(rootView(u"/home"), u"/");
+    QCOMPARE(rootView(u"c:\\folder"), u"c:\\");
+    QCOMPARE(rootView(u"D:"), u"D:");
+    QVERIFY(rootView(u"folder/file").isEmpty());
+}
+
+void test_pathstr::test_suffixView()
+{
+    using namespace pathstr;
+    QCOMPARE(suffixView(u"file.TXT"), u"TXT");
+    QCOMPARE(suffixView(u"/folder/archive.tar.gz"), u"gz");
+    QCOMPARE(suffixView(u"/folder/file.txt/"), u"txt");
+    QVERIFY(suffixView(u"/folder.2/.hidden_file").isEmpty());
+}
+
+void test_pathstr::test_completeSuffixView()
+{
+    using namespace pathstr;
+    QCOMPARE(completeSuffixView(u"/folder/archive.Tar.gz"), u"Tar.gz");
+    QCOMPARE(completeSuffixView(u"file.name.with.dots.tar.gz"), u"tar.gz");
+    QCOMPARE(completeSuffixView(u"folder/.hidden_file.txt"), u"txt");
+    QVERIFY(completeSuffixView(u"folder/1.").isEmpty());
+}
+
+void test_pathstr::test_lowerSuffixView()
+{
+    using namespace pathstr;
+    QString buffer;
+    QCOMPARE(lowerSuffixView(u"/folder/archive.Tar.GZ", buffer), u"gz");
+    QCOMPARE(lowerCompleteSuffixView(u"/folder/archive.Tar.GZ", buffer), u"tar.gz");
+    QVERIFY(lowerSuffixView(u"folder/.hidden_file", buffer).isNull());
+
+    buffer.reserve(64);
+    const QChar *data = buffer.constData();
+    QCOMPARE(lowerSuffixView(u"FILE.JPEG", buffer), u"jpeg");
+    QVERIFY(buffer.constData() == data);
+
+    // differential: the ASCII fast paths give the same results as the Unicode case folding
+    const QString alphabet = QStringLiteral(u"aZk.T./\\0x\u00C0\u00DF\u0130\u212A\u017F\u03A3\u0416\U00010400");
+    quint32 seed = 1;
+    auto random = [&seed](int max) { seed = seed * 1664525u + 1013904223u; return int((seed >> 8) % max); };
+
+    for (int n = 0; n < 3000; ++n) {
+        QString name;
+        const int size = random(12);
+        for (int i = 0; i < size; ++i) {
+            const int pos = random(alphabet.size());
+            if (alphabet.at(pos).isLowSurrogate())
+                name += alphabet.mid(pos - 1, 2);
+            else if (alphabet.at(pos).isHighSurrogate())
+                name += alphabet.mid(pos, 2);
+            else
+                name += alphabet.at(pos);
+        }
+
+        const QStringView suf = suffixView(name);
+        const QStringView csuf = completeSuffixView(name);
+        const QString expSuf = suf.isEmpty() ? QString() : suf.toString().toLower();
+        const QString expCsuf = csuf.isEmpty() ? QString() : csuf.toString().toLower();
+        QCOMPARE(suffix(name), expSuf);
+        QCOMPARE(completeSuffix(name), expCsuf);
+        QCOMPARE(lowerSuffixView(name, buffer).toString(), expSuf);
+        QCOMPARE(lowerCompleteSuffixView(name, buffer).toString(), expCsuf);
+
+        // against the suffixes of other names, changed case, and the Unicode comparison
+        for (const QString &ext : { expCsuf, csuf.toString().toUpper(), suf.toString(), name.right(3) }) {
+            const bool extDot = ext.startsWith(u'.');
+            const int dotInd = name.size() - ext.size() - (extDot ? 0 : 1);
+            const bool expected = ext.isEmpty() ? suf.isEmpty()
+                                                : (dotInd > 0 && name.at(dotInd) == u'.'
+                                                   && QStringView(name).right(ext.size()).compare(ext, Qt::CaseInsensitive) == 0);
+            QCOMPARE(hasExtension(name, ext), expected);
+        }
+    }
+}
+
+void test_pathstr::test_ExtensionSet()
+{
+    using namespace pathstr;
+    const ExtensionSet set({ "txt", ".H", "tar.gz", ".cpp" });
+    QCOMPARE(set.size(), 4);
+    QVERIFY(set.contains(u"TXT"));
+    QVERIFY(set.contains(u".h"));
+    QVERIFY(!set.contains(u"gz"));
+    QVERIFY(set.matches(u"file.cpp"));
+    QVERIFY(set.matches(u"/folder/file.ver.TXT"));
+    QVERIFY(set.matches(u"folder/.archive.tar.GZ"));
+    QVERIFY(set.matches(u"folder/.h"));
+    QVERIFY(!set.matches(u"file.gz"));
+    QVERIFY(!set.matches(u"file.tar.gz.zip"));
+    QVERIFY(!set.matches(u".txt"));
+    QVERIFY(!set.matches(u"file"));
+    QVERIFY(!set.matches(u"txt/file"));
+    QVERIFY(hasExtension("file.h", set));
+
+    const ExtensionSet noSuffix({ "" });
+    QVERIFY(noSuffix.matches(u"file"));
+    QVERIFY(noSuffix.matches(u".file"));
+    QVERIFY(!noSuffix.matches(u"file.txt"));
+    QVERIFY(ExtensionSet().isEmpty());
+
+    // the same results as the QStringList overload
+    const QStringList exts = { "jpg", "H", "tar.gz", "json", "" };
+    const ExtensionSet extSet(exts);
+    const QStringList files = { "a.jpg", "a.JPG", "b.h", "c.tar.gz", "d.gz", ".json",
+                                "dir/.json", "e", ".e", "f.", "dir.jpg/g" };
+    for (const QString &file : files)
+        QCOMPARE(extSet.matches(file), hasExtension(file, exts));
+}
+
+void test_pathstr::test_PathInfo()
+{
+    using namespace pathstr;
+    const PathInfo info(u"/home/folder/archive.tar.gz");
+    QCOMPARE(info.entryName(), u"archive.tar.gz");
+    QCOMPARE(info.baseName(), u"archive");
+    QCOMPARE(info.suffix(), u"gz");
+    QCOMPARE(info.completeSuffix(), u"tar.gz");
+    QCOMPARE(info.parentFolder(), u"/home/folder");
+    QCOMPARE(info.parentName(), u"folder");
+    QCOMPARE(info.rootPath(), u"/");
+    QVERIFY(info.isAbsolute());
+    QVERIFY(!info.isRoot());
+
+    const PathInfo folder(u"C:/folder.2/");
+    QVERIFY(folder.trailingSep);
+    QCOMPARE(folder.entryName(), u"folder.2");
+    QCOMPARE(folder.suffix(), u"2");
+    QCOMPARE(folder.parentFolder(), u"C:/");
+    QVERIFY(folder.parentName().isEmpty());
+    QVERIFY(folder.hasWindowsRoot());
+
+    const PathInfo root(u"D:\\");
+    QVERIFY(root.isRoot());
+    QVERIFY(root.entryName().isEmpty());
+    QCOMPARE(root.parentFolder(), u"D:\\");
+
+    const PathInfo hidden(u"folder/.hidden_file.epub.zip");
+    QCOMPARE(hidden.baseName(), u".hidden_file");
+    QCOMPARE(hidden.completeSuffix(), u"epub.zip");
+    QVERIFY(hidden.isRelative());
+    QVERIFY(PathInfo(u"folder/1.").completeSuffix().isEmpty());
+}
+
+void test_pathstr::test_PathComponents()
+{
+    using namespace pathstr;
+    auto names = [](QStringView path) {
+        QStringList list;
+        for (QStringView name : PathComponents(path))
+            list << name.toString();
+        return list;
+    };
+    auto reversed = [](QStringView path) {
+        QStringList list;
+        const PathComponents comps(path);
+        for (auto it = comps.rbegin(); it != comps.rend(); ++it)
+            list.prepend((*it).toString());
+        return list;
+    };
+
+    QCOMPARE(names(u"/home/user//file.txt/"), QStringList({ "/", "home", "user", "file.txt" }));
+    QCOMPARE(names(u"C:\\folder\\\\file"), QStringList({ "C:\\", "folder", "file" }));
+    QCOMPARE(names(u"c:folder/"), QStringList({ "c:", "folder" }));
+    QCOMPARE(names(u"//a"), QStringList({ "/", "a" }));
+    QCOMPARE(names(u"\\\\server\\share"), QStringList({ "server", "share" }));
+    QCOMPARE(names(u"/"), QStringList({ "/" }));
+    QCOMPARE(names(u"folder"), QStringList({ "folder" }));
+    QVERIFY(names(u"").isEmpty());
+    QVERIFY(names(u"//\\").size() == 1);
+    QVERIFY(names(u"\\\\").isEmpty());
+
+    for (QStringView path : { u"/home/user//file.txt/", u"C:\\folder\\\\file", u"c:folder/", u"//a",
+                              u"C://", u"a/b\\c", u"/", u"", u"\\\\", u"folder/./../x" })
+        QCOMPARE(reversed(path), names(path));
+
+    // the ancestors, also from the iterators
+    const PathComponents comps(u"/home/user//file.txt");
+    QCOMPARE(comps.count(), 4);
+    QCOMPARE(comps.root(), u"/");
+    QCOMPARE(comps.last(), u"file.txt");
+    QCOMPARE(comps.ancestor(0), u"/");
+    QCOMPARE(comps.ancestor(1), u"/home");
+    QCOMPARE(comps.ancestor(3), u"/home/user//file.txt");
+    QVERIFY(comps.ancestor(4).isNull());
+    QVERIFY(comps.ancestor(-1).isNull());
+    QVERIFY(comps.begin().isRoot());
+
+    QStringList ancestors;
+    for (auto it = comps.rbegin(); it != comps.rend(); ++it)
+        ancestors << it.path().toString();
+    QCOMPARE(ancestors, QStringList({ "/home/user//file.txt", "/home/user", "/home", "/" }));
+
+    auto it = comps.end();
+    --it;
+    QCOMPARE(*it, u"file.txt");
+    QCOMPARE(*--it, u"user");
+    QCOMPARE(*it++, u"user");
+    QVERIFY(++it == comps.end());
+
+    QCOMPARE(PathComponents(u"D:/").ancestor(0), u"D:/");
+    QVERIFY(PathComponents(u"folder").root().isNull());
+    QVERIFY(PathComponents(u"").last().isNull());
+    QVERIFY(PathComponents(u"").isEmpty());
+
+    // the core template over std::string_view
+    const core::BasicPathComponents<std::string_view> utf8("/папка/file");
+    QCOMPARE(utf8.count(), 3);
+    QVERIFY(utf8.ancestor(1) == "/папка");
+    QVERIFY(utf8.last() == "file");
+}
+
+void test_pathstr::test_simd()
+{
+    using namespace pathstr;
+    // lengths around the block sizes, separators and dots at every position
+    const QString pattern = QStringLiteral(u"abc.d/ef\\g.h.ij/kl.mnop\\q/r.s.t");
+
+    for (int size = 0; size < 80; ++size) {
+        QString str;
+        while (str.size() < size)
+            str += pattern;
+        str.truncate(size);
+        const char16_t *data = str.utf16();
+
+        // scanBack
+        int dots[3];
+        const int sep = simd::scanBack(data, size, u'/', u'\\', u'.', dots);
+        int expSep = size - 1;
+        int expDots[3] = { -1, -1, -1 };
+        int dotCount = 0;
+        for (; expSep >= 0 && data[expSep] != u'/' && data[expSep] != u'\\'; --expSep) {
+            if (data[expSep] == u'.' && dotCount < 3)
+                expDots[dotCount++] = expSep;
+        }
+        QCOMPARE(sep, expSep);
+        QCOMPARE(dots[0], expDots[0]);
+        QCOMPARE(dots[1], expDots[1]);
+        QCOMPARE(dots[2], expDots[2]);
+
+        // lastIndexOf
+        QCOMPARE(simd::lastIndexOf(data, size, u'/', u'/'), int(str.lastIndexOf(u'/')));
+
+        // the byte kernels, the same positions
+        const std::string bytes = str.toStdString();
+        int byteDots[3];
+        QCOMPARE(simd::scanBack(bytes.data(), size, '/', '\\', '.', byteDots), expSep);
+        QCOMPARE(byteDots[0], expDots[0]);
+        QCOMPARE(byteDots[1], expDots[1]);
+        QCOMPARE(byteDots[2], expDots[2]);
+        QCOMPARE(simd::lastIndexOf(bytes.data(), size, '/', '/'), int(str.lastIndexOf(u'/')));
+
+        // mismatch at every position
+        for (int pos = 0; pos <= size; ++pos) {
+            QString other = str;
+            if (pos < size)
+                other[pos] = u'#';
+            QCOMPARE(simd::mismatch(data, other.utf16(), size), pos);
+        }
+    }
+
+    // the ASCII case folding: letters around 'A'-'Z', 'a'-'z' and non-ASCII units at every position
+    const QString letters = QStringLiteral(u"@AZ[`az{Mm.0");
+    for (int size = 0; size < 40; ++size) {
+        QString str;
+        for (int i = 0; i < size; ++i)
+            str += letters.at((i * 5 + size) % letters.size());
+        const QString lower = str.toLower();
+
+        for (int pos = -1; pos < size; ++pos) {
+            QString other = str;
+            if (pos >= 0)
+                other[pos] = (pos % 2) ? QChar(0x212A) : QChar(0x8041); // KELVIN SIGN, a negative short
+            const char16_t *data = other.utf16();
+
+            QString lowered(size, u' ');
+            const int nonAscii = simd::lowerAscii(data, reinterpret_cast<char16_t *>(lowered.data()), size);
+            QCOMPARE(nonAscii, (pos == -1) ? size : pos);
+            for (int i = 0; i < size; ++i)
+                QCOMPARE(lowered.at(i), (i == pos) ? other.at(i) : lower.at(i));
+
+            // equal, differs in the ASCII letters, differs at a non-ASCII unit only
+            QCOMPARE(simd::equalsAsciiNoCase(data, other.utf16(), size), (pos == -1) ? 1 : -1);
+            QCOMPARE(simd::equalsAsciiNoCase(lower.utf16(), str.utf16(), size), 1);
+            if (pos >= 0) {
+                QCOMPARE(simd::equalsAsciiNoCase(data, str.utf16(), size), -1);
+                QString changed = lower;
+                changed[size - 1 - pos] = QChar(u'#');
+                if (size - 1 - pos != pos && changed != lower)
+                    QCOMPARE(simd::equalsAsciiNoCase(data, changed.utf16(), size), 0);
+            }
+        }
+    }
+}
+
+void test_pathstr::test_PathBuilder()
+{
+    using namespace pathstr;
+    PathBuilder builder(u"/home");
+    QCOMPARE(builder.push(u"folder/").path(), u"/home/folder/");
+    QCOMPARE(builder.push(u"\\file.txt").path(), u"/home/folder\\file.txt");
+    QCOMPARE(builder.depth(), 2);
+    builder.pop();
+    QCOMPARE(builder.path(), u"/home/folder/");
+    QCOMPARE(builder.pushFile(u"archive", u"tar.gz").path(), u"/home/folder/archive.tar.gz");
+    builder.pop();
+    builder.pop();
+    QCOMPARE(builder.path(), u"/home");
+    builder.pop();
+    QCOMPARE(builder.path(), u"/home");
+
+    // the same results as joinPath() and composeFilePath()
+    const QStringList parts = { "C:\\folder\\", "/folder2/", "file", "\\sub", "" };
+    for (const QString &first : parts) {
+        for (const QString &second : parts) {
+            builder.reset(u"/root/");
+            builder.push(first).push(second);
+            QCOMPARE(builder.toString(), joinPath(joinPath("/root/", first), second));
+            builder.pop();
+            QCOMPARE(builder.toString(), joinPath("/root/", first));
+            builder.pushFile(second, u".txt");
+            QCOMPARE(builder.toString(), composeFilePath(joinPath("/root/", first), second, ".txt"));
+        }
+    }
+
+    PathBuilder relative;
+    QCOMPARE(relative.push(u"folder").path(), u"folder");
+}
+
+void test_pathstr::test_PathArena()
+{
+    using namespace pathstr;
+    PathArena arena(16);
+    const QStringView first = arena.store(u"/home/folder");
+    const QStringView big = arena.store(u"/home/folder/very_long_file_name.txt");
+    const QStringView second = arena.store(u"/home");
+    QCOMPARE(first, u"/home/folder");
+    QCOMPARE(big, u"/home/folder/very_long_file_name.txt");
+    QCOMPARE(second, u"/home");
+    QCOMPARE(arena.count(), 3);
+    QCOMPARE(arena.size(), 53);
+
+    QStringList stored;
+    for (int i = 0; i < 100; ++i)
+        stored.append(arena.store(QString::number(i)).toString());
+    QCOMPARE(first, u"/home/folder");
+    QCOMPARE(stored.at(42), "42");
+
+    arena.clear();
+    QCOMPARE(arena.count(), 0);
+    QCOMPARE(arena.store(u"file"), u"file");
+}
+
+// enough paths for several chunks
+static QStringList batchPaths()
+{
+    const QStringList names = { "file.txt", "archive.tar.gz", "photo.JPG", "folder/", "noSuffix", "C:/", "sub/main.cpp" };
+    QStringList paths;
+    for (int i = 0; i < 5000; ++i)
+        paths.append("/root/folder" + QString::number(i % 17) + '/' + names.at(i % names.size()));
+    return paths;
+}
+
+void test_pathstr::test_relativePaths()
+{
+    using namespace pathstr;
+    const QStringList paths = batchPaths();
+    const QStringList result = relativePaths("/root", paths, 4);
+    QCOMPARE(result.size(), paths.size());
+    for (int i = 0; i < paths.size(); ++i)
+        QCOMPARE(result.at(i), relativePath("/root", paths.at(i)));
+
+    QCOMPARE(relativePaths("/root", { "/root/file", "/other/file" }), QStringList({ "file", QString() }));
+    QVERIFY(relativePaths("/root", QStringList()).isEmpty());
+}
+
+void test_pathstr::test_setSuffixes()
+{
+    using namespace pathstr;
+    const QStringList paths = batchPaths();
+    const QStringList result = setSuffixes(paths, "zip", 3);
+    QCOMPARE(result.size(), paths.size());
+    for (int i = 0; i < paths.size(); ++i)
+        QCOMPARE(result.at(i), setSuffix(paths.at(i), "zip"));
+
+    QCOMPARE(setSuffixes({ "file.txt", "file" }, "zip", 1), QStringList({ "file.zip", "file.zip" }));
+}
+
+void test_pathstr::test_renameFiles()
+{
+    using namespace pathstr;
+    const QStringList paths = batchPaths();
+    const QStringList result = renameFiles(paths, "newName", 8);
+    QCOMPARE(result.size(), paths.size());
+    for (int i = 0; i < paths.size(); ++i)
+        QCOMPARE(result.at(i), renameFile(paths.at(i), "newName"));
+}
+
+void test_pathstr::test_filterByExtension()
+{
+    using namespace pathstr;
+    const QStringList paths = batchPaths();
+    const ExtensionSet extensions({ "txt", "jpg", "gz" });
+
+    QStringList expected;
+    for (const QString &path : paths) {
+        if (hasExtension(path, extensions))
+            expected.append(path);
+    }
+
+    QCOMPARE(filterByExtension(paths, extensions, 4), expected);
+    QCOMPARE(filterByExtension(paths, extensions, 1), expected);
+    QVERIFY(filterByExtension(paths, ExtensionSet({ "zip" })).isEmpty());
+}
+
+void test_pathstr::test_coreUtf8()
+{
+    using namespace pathstr;
+    using std::string_view;
+    QVERIFY(core::entryName(string_view("/folder/файл.txt")) == "файл.txt");
+    QVERIFY(core::baseName(string_view("/folder/архив.tar.gz")) == "архив");
+    QVERIFY(core::suffix(string_view("/folder/file.TXT")) == "TXT");
+    QVERIFY(core::completeSuffix(string_view("/folder/archive.tar.gz")) == "tar.gz");
+    QVERIFY(core::parentFolder(string_view("/папка/folder2/")) == "/папка");
+    QVERIFY(core::parentFolder(string_view("C:/folder")) == "C:/");
+    QVERIFY(core::relativePath(string_view("/root/"), string_view("/root/folder/file")) == "folder/file");
+    QVERIFY(core::relativePath(string_view("/root"), string_view("/rootfolder/file")).data() == nullptr);
+    QVERIFY(core::root(string_view("C:\\folder")) == "C:\\");
+    QVERIFY(core::isRoot(string_view("/")));
+    QVERIFY(!core::isRoot(string_view("/folder")));
+    QVERIFY(core::hasExtension(string_view("/folder/Фото.JPG"), string_view(".jpg")));
+    QVERIFY(!core::hasExtension(string_view("/folder/file.txt"), string_view("xt")));
+
+    // the same results as the QString API
+    const QStringList paths = { "/folder/файл.tar.gz", "C:/", "D:", "folder/.hidden", "/папка/", "file.", "/a.b.c/d" };
+    for (const QString &path : paths) {
+        const QByteArray utf8 = path.toUtf8();
+        const string_view view(utf8.constData(), utf8.size());
+        const core::BasicPathInfo<string_view> info(view);
+        QCOMPARE(QString::fromUtf8(info.parentFolder().data(), int(info.parentFolder().size())), parentFolder(path));
+        QCOMPARE(QString::fromUtf8(info.completeSuffix().data(), int(info.completeSuffix().size())), completeSuffix(path, false));
+        QCOMPARE(info.isRoot(), isRoot(path));
+    }
+}
+
+void test_pathstr::test_coreUtf16()
+{
+    using namespace pathstr;
+    using std::u16string_view;
+    QVERIFY(core::entryName(u16string_view(u"/folder/file.txt")) == u"file.txt");
+    QVERIFY(core::baseName(u16string_view(u"/folder/archive.tar.gz")) == u"archive");
+    QVERIFY(core::suffix(u16string_view(u"/folder/file.TXT")) == u"TXT");
+    QVERIFY(core::parentFolder(u16string_view(u"/folder/folder2/")) == u"/folder");
+    QVERIFY(core::relativePath(u16string_view(u"/root"), u16string_view(u"/root/file")) == u"file");
+    QVERIFY(core::root(u16string_view(u"/folder")) == u"/");
+    QVERIFY(core::isAbsolute(u16string_view(u"C:/folder")));
+    QVERIFY(core::isRelative(u16string_view(u"folder")));
+    QVERIFY(core::hasExtension(u16string_view(u"archive.TAR.gz"), u16string_view(u"tar.GZ")));
+    QVERIFY(core::hasExtension(u16string_view(u"file"), u16string_view()));
+}
+
+void test_pathstr::test_corePolicies()
+{
+    using namespace pathstr::core;
+    using std::string_view;
+
+    // POSIX: no drive roots, '\\' is an ordinary character
+    QVERIFY(!hasWindowsRoot<PosixPolicy>(string_view("C:/folder")));
+    QVERIFY(!isRoot<PosixPolicy>(string_view("C:/")));
+    QVERIFY(isRoot<PosixPolicy>(string_view("/")));
+    QVERIFY(isRelative<PosixPolicy>(string_view("C:/folder")));
+    QVERIFY(root<PosixPolicy>(string_view("C:/folder")).data() == nullptr);
+    QVERIFY(parentFolder<PosixPolicy>(string_view("C:/file")) == "C:");
+    QVERIFY(entryName<PosixPolicy>(string_view("/dir/a\\b")) == "a\\b");
+    QVERIFY(!isSeparator<PosixPolicy>('\\'));
+    typedef BasicPathComponents<string_view, PosixPolicy> PosixComponents;
+    QCOMPARE(PosixComponents("/a\\b/c").count(), 3);
+
+    // Windows: '\\' splits the paths as '/' does
+    QVERIFY(entryName<WindowsPolicy>(string_view("C:\\dir\\file.txt")) == "file.txt");
+    QVERIFY(parentFolder<WindowsPolicy>(string_view("C:\\dir\\file\\")) == "C:\\dir");
+    QVERIFY(parentFolder<WindowsPolicy>(string_view("C:\\file")) == "C:\\");
+    QVERIFY(relativePath<WindowsPolicy>(string_view("C:\\dir\\"), string_view("C:\\dir\\file")) == "file");
+    QVERIFY(root<WindowsPolicy>(string_view("\\dir")) == "\\");
+    QVERIFY(isRoot<WindowsPolicy>(string_view("C:\\")));
+    typedef BasicPathInfo<string_view, WindowsPolicy> WindowsPathInfo;
+    QVERIFY(WindowsPathInfo("C:\\dir\\").trailingSep);
+    QVERIFY(baseName<WindowsPolicy>(string_view("a.b\\archive.tar.gz")) == "archive");
+
+    // the default is the mixed one of the Qt API
+    QVERIFY(entryName(string_view("C:\\dir\\file")) == entryName<MixedPolicy>(string_view("C:\\dir\\file")));
+    QVERIFY(entryName(string_view("C:\\dir\\file")) == "C:\\dir\\file");
+
+    // the POSIX paths give the same results under every policy
+    for (string_view path : { "/home/user/archive.tar.gz", "/", "folder/", "file", "/a.b/.hidden", "" }) {
+        QVERIFY(parentFolder<PosixPolicy>(path) == parentFolder<MixedPolicy>(path));
+        QVERIFY(parentFolder<WindowsPolicy>(path) == parentFolder<MixedPolicy>(path));
+        QVERIFY(completeSuffix<PosixPolicy>(path) == completeSuffix(path));
+        QVERIFY(isAbsolute<PosixPolicy>(path) == isAbsolute(path));
+        QVERIFY(isRoot<WindowsPolicy>(path) == isRoot(path));
+    }
+}
+
+static void writeFile(const QString &fileName, const std::string &content)
+{
+    std::FILE *file = std::fopen(qPrintable(fileName), "wb");
+    QVERIFY(file);
+    std::fwrite(content.data(), 1, content.size(), file);
+    std::fclose(file);
+}
+
+static std::vector<std::string> readLines(const pathstr::core::MappedPathList &list)
+{
+    std::vector<std::string> lines;
+    list.forEachLine([&](std::string_view line) { lines.emplace_back(line); });
+    return lines;
+}
+
+void test_pathstr::test_MappedPathList()
+{
+    using namespace pathstr::core;
+    const QTemporaryDir dir;
+    const QString fileName = dir.filePath("list.txt");
+    writeFile(fileName, "/folder/file.txt\r\n\n/folder/папка/\nC:/file");
+
+    MappedPathList list(fileName.toStdString());
+    QVERIFY(list.isOpen());
+    QCOMPARE(int(list.data().size()), int(std::strlen("/folder/file.txt\r\n\n/folder/папка/\nC:/file")));
+    QVERIFY(readLines(list) == std::vector<std::string>({ "/folder/file.txt", "/folder/папка/", "C:/file" }));
+
+    // empty and missing files
+    writeFile(fileName, std::string());
+    QVERIFY(list.open(fileName.toStdString()));
+    QVERIFY(readLines(list).empty());
+    QVERIFY(!list.open(dir.filePath("missing.txt").toStdString()));
+    QVERIFY(!list.isOpen());
+}
+
+void test_pathstr::test_PathListWriter()
+{
+    using namespace pathstr::core;
+    const QTemporaryDir dir;
+    const std::string fileName = dir.filePath("out.txt").toStdString();
+    {
+        // a tiny buffer: flushed often, the long lines are written directly
+        PathListWriter writer(fileName, 8);
+        QVERIFY(writer.isOpen());
+        writer.write("/a/b");
+        writer("/folder/long_file_name.txt");
+        writer.write("c");
+        QVERIFY(writer.flush());
+    }
+
+    const MappedPathList list(fileName);
+    QVERIFY(list.data() == "/a/b\n/folder/long_file_name.txt\nc\n");
+}
+
+void test_pathstr::test_pathListOperations()
+{
+    using namespace pathstr::core;
+    const QTemporaryDir dir;
+    const QString fileName = dir.filePath("list.txt");
+    writeFile(fileName, "/root/a/file.txt\n/root/a/archive.tar.gz\n/root/a/b/photo.JPG\n/other/doc\n/root/a/b/c.\n");
+    const MappedPathList list(fileName.toStdString());
+
+    std::vector<std::string> result;
+    auto collect = [&](std::string_view path) { result.emplace_back(path); };
+
+    filterByExtension(list, { "jpg", ".txt" }, collect);
+    QVERIFY(result == std::vector<std::string>({ "/root/a/file.txt", "/root/a/b/photo.JPG" }));
+
+    // a runtime list, prebuilt once
+    const std::vector<std::string> configured = { "GZ", "", ".jpg" };
+    const ExtensionSet extSet(configured.begin(), configured.end());
+    QCOMPARE(extSet.size(), 3);
+    QVERIFY(extSet.contains("gz") && extSet.contains(".Jpg") && !extSet.contains("tar.gz"));
+
+    result.clear();
+    filterByExtension(list, extSet, collect);
+    QVERIFY(result == std::vector<std::string>({ "/root/a/archive.tar.gz", "/root/a/b/photo.JPG", "/other/doc", "/root/a/b/c." }));
+
+    // the same results as hasExtension() with each extension
+    const ExtensionSet multi({ "tar.gz", "txt", "a.b", "" });
+    for (std::string_view path : { "a.tar.gz", "a.TAR.GZ", "b.gz", ".txt", "x.txt", "/a.b/c", "/x/a.b", "c.a.b",
+                                   "noext", "dir.d/noext", "dot.", ".hidden", "/.txt", "a.b.txt/" }) {
+        bool expected = false;
+        for (std::string_view ext : { "tar.gz", "txt", "a.b", "" })
+            expected = expected || hasExtension(path, ext);
+        QCOMPARE(multi.matches(path), expected);
+    }
+
+    result.clear();
+    relativePaths(list, "/root/", collect);
+    QVERIFY(result == std::vector<std::string>({ "a/file.txt", "a/archive.tar.gz", "a/b/photo.JPG", "a/b/c." }));
+
+    result.clear();
+    setSuffixes(list, "zip", collect);
+    QVERIFY(result == std::vector<std::string>({ "/root/a/file.zip", "/root/a/archive.tar.zip",
+                                                 "/root/a/b/photo.zip", "/other/doc.zip", "/root/a/b/c.zip" }));
+
+    // the same results as the QString API
+    list.forEachLine([](std::string_view path) {
+        const QString qpath = QString::fromUtf8(path.data(), int(path.size()));
+        const std::string_view rel = relativePath(std::string_view("/root/a"), path);
+        QCOMPARE(QString::fromUtf8(rel.data(), int(rel.size())), pathstr::relativePath("/root/a", qpath));
+    });
+
+    std::vector<std::string> groups;
+    groupByParent(list, [&](std::string_view parent, const std::vector<std::string_view> &entries) {
+        std::string group(parent);
+        for (std::string_view entry : entries)
+            group.append(" ").append(entry);
+        groups.push_back(group);
+    });
+    QVERIFY(groups == std::vector<std::string>({ "/root/a file.txt archive.tar.gz", "/root/a/b photo.JPG",
+                                                 "/other doc", "/root/a/b c." }));
+
+    // the snapshots sorted in the comparePaths() order
+    const QString prevName = dir.filePath("prev.txt");
+    writeFile(prevName, "/a/file\n/b/x\n/b/x/1\n/b/x/2\n/b/y\n/c\n");
+    writeFile(fileName, "/a/file\n/a/new\n/b/y\n/d\n");
+    const MappedPathList previous(prevName.toStdString());
+    const MappedPathList current(fileName.toStdString());
+
+    result.clear();
+    diffSnapshots(previous, current, [&](DiffKind kind, std::string_view path) {
+        const char *prefix = (kind == DiffKind::Added) ? "+" : (kind == DiffKind::Removed ? "-" : "-/");
+        result.push_back(prefix + std::string(path));
+    });
+    QVERIFY(result == std::vector<std::string>({ "+/a/new", "-//b/x", "-/c", "+/d" }));
+}
+
+void test_pathstr::test_PathTree()
+{
+    using namespace pathstr;
+    PathTree tree;
+    const PathTree::Handle file = tree.insert(u"/home/folder/file.txt");
+    const PathTree::Handle file2 = tree.insert(u"/home/folder/file2.txt");
+    const PathTree::Handle other = tree.insert(u"/home/folder.2//other/");
+    const PathTree::Handle drive = tree.insert(u"C:\\folder/file.txt");
+    const PathTree::Handle relative = tree.insert(u"folder/file.txt");
+
+    QCOMPARE(tree.size(), 12);
+    QCOMPARE(tree.nameCount(), 8);
+    QCOMPARE(tree.path(file), "/home/folder/file.txt");
+    QCOMPARE(tree.path(other), "/home/folder.2/other");
+    QCOMPARE(tree.path(drive), "C:\\folder/file.txt");
+    QCOMPARE(tree.path(relative), "folder/file.txt");
+    QCOMPARE(tree.entryName(file2), u"file2.txt");
+    QCOMPARE(tree.entryName(tree.find(u"/")), u"/");
+    QCOMPARE(tree.depth(file), 4);
+    QCOMPARE(tree.parent(file), tree.parent(file2));
+    QCOMPARE(tree.path(tree.parent(file)), parentFolder("/home/folder/file.txt"));
+    QCOMPARE(tree.parent(tree.find(u"/")), PathTree::s_none);
+
+    // the same handles for the same paths
+    QCOMPARE(tree.insert(u"/home/folder/file.txt"), file);
+    QCOMPARE(tree.find(u"/home/folder/file.txt"), file);
+    QCOMPARE(tree.find(u"/home/folder.2/other"), other);
+    QCOMPARE(tree.find(u"folder/file.txt"), relative);
+    QCOMPARE(tree.find(u"/home/missing"), PathTree::s_none);
+    QCOMPARE(tree.find(u"missing/file.txt"), PathTree::s_none);
+    QCOMPARE(tree.child(tree.parent(file), u"file2.txt"), file2);
+
+    const PathTree::Handle home = tree.find(u"/home");
+    QVERIFY(tree.isAncestor(home, file));
+    QVERIFY(!tree.isAncestor(file, home));
+    QVERIFY(!tree.isAncestor(home, home));
+    QVERIFY(!tree.isAncestor(home, drive));
+    QCOMPARE(tree.relativePath(home, file), relativePath("/home", "/home/folder/file.txt"));
+    QVERIFY(tree.relativePath(home, home).isNull());
+    QVERIFY(tree.relativePath(home, drive).isNull());
+
+    // bulk insert: the handles and the paths match those of single inserts
+    const QStringList paths = batchPaths();
+    PathTree bulk;
+    const QVector<PathTree::Handle> handles = bulk.insert(paths);
+    QCOMPARE(int(handles.size()), int(paths.size()));
+    for (int i = 0; i < paths.size(); ++i) {
+        QCOMPARE(bulk.find(paths.at(i)), handles.at(i));
+        QCOMPARE(bulk.path(handles.at(i)), chopSep(paths.at(i)));
+    }
+}
+
+void test_pathstr::test_normalize()
+{
+    using namespace pathstr;
+    QCOMPARE(normalize("/home//folder/./file"), "/home/folder/file");
+    QCOMPARE(normalize("/home/folder/"), "/home/folder");
+    QCOMPARE(normalize("/home/folder/../folder2/file"), "/home/folder2/file");
+    QCOMPARE(normalize("/.."), "/");
+    QCOMPARE(normalize("//"), "/");
+    QCOMPARE(normalize("c:\\folder\\..\\folder2\\"), "C:/folder2");
+    QCOMPARE(normalize("C:"), "C:/");
+    QCOMPARE(normalize("C:folder"), "C:/folder");
+    QCOMPARE(normalize("C:/.."), "C:/");
+    QCOMPARE(normalize("../folder/../file"), "../file");
+    QCOMPARE(normalize("./../../file"), "../../file");
+    QCOMPARE(normalize("folder/.."), ".");
+    QCOMPARE(normalize("./"), ".");
+    QCOMPARE(normalize("folder/../C:file"), "./C:file");
+    QCOMPARE(normalize(""), "");
+    QCOMPARE(normalize("/home/folder\\file"), "/home/folder/file");
+    QCOMPARE(normalize("/home/folder\\file", false), "/home/folder\\file");
+    QCOMPARE(normalize("/home//a\\b/", false), "/home/a\\b");
+
+    // nothing is allocated for a normalized path
+    const QString normal("/home/folder/file");
+    QVERIFY(normalize(normal).constData() == normal.constData());
+
+    // in place
+    QString str("/home//folder/./file/");
+    const QChar *data = str.constData();
+    const QString moved = normalize(std::move(str));
+    QCOMPARE(moved, "/home/folder/file");
+    QVERIFY(moved.constData() == data);
+
+    // shared data is not changed
+    const QString orig("/home//folder");
+    QString copy = orig;
+    QCOMPARE(normalize(std::move(copy)), "/home/folder");
+    QCOMPARE(orig, "/home//folder");
+
+    QString buffer;
+    QCOMPARE(normalize(u"/a/./b//c/", buffer), u"/a/b/c");
+    QCOMPARE(normalize(u"d:", buffer), u"D:/");
+    const QStringView view(normal);
+    QVERIFY(normalize(view, buffer).data() == view.data());
+
+    // the result is normalized, normalizing it again changes nothing
+    const QStringList paths { "/a/b/../../..", "a/./b/../../..", "C:\\a\\..\\..", "\\\\server\\share",
+                              "a//b\\/c/.", "../..", "/../a/./b/..", "c:a/../../b" };
+    for (const QString &path : paths) {
+        const QString res = normalize(path);
+        QVERIFY(isNormalized(res));
+        QCOMPARE(normalize(res), res);
+        QCOMPARE(normalize(QString(path)), res);
+        QCOMPARE(normalize(QStringView(path), buffer), QStringView(res));
+    }
+}
+
+void test_pathstr::test_isNormalized()
+{
+    using namespace pathstr;
+    QVERIFY(isNormalized(u""));
+    QVERIFY(isNormalized(u"/"));
+    QVERIFY(isNormalized(u"."));
+    QVERIFY(isNormalized(u"C:/"));
+    QVERIFY(isNormalized(u"/home/folder/file"));
+    QVERIFY(isNormalized(u"../../folder"));
+    QVERIFY(isNormalized(u"folder/.hidden/..file"));
+    QVERIFY(isNormalized(u"a\\b", false));
+    QVERIFY(isNormalized(u"./C:file"));
+
+    QVERIFY(!isNormalized(u"C:"));
+    QVERIFY(!isNormalized(u"c:/"));
+    QVERIFY(!isNormalized(u"C:\\"));
+    QVERIFY(!isNormalized(u"/home/"));
+    QVERIFY(!isNormalized(u"/home//folder"));
+    QVERIFY(!isNormalized(u"/home/./folder"));
+    QVERIFY(!isNormalized(u"/home/../folder"));
+    QVERIFY(!isNormalized(u"/.."));
+    QVERIFY(!isNormalized(u"folder/../.."));
+    QVERIFY(!isNormalized(u"./folder"));
+    QVERIFY(!isNormalized(u"a\\b"));
+}
+
+void test_pathstr::test_PathGlob()
+{
+    using namespace pathstr;
+    const PathGlob objects("**/build/*.o");
+    QVERIFY(objects.matches(u"/home/project/build/main.o"));
+    QVERIFY(objects.matches(u"build/main.o"));
+    QVERIFY(objects.matches(u"C:\\project\\build\\main.o"));
+    QVERIFY(objects.matches(u"/home//project/build/main.o/"));
+    QVERIFY(!objects.matches(u"/home/project/src/main.o"));
+    QVERIFY(!objects.matches(u"/home/project/build/sub/main.o"));
+    QVERIFY(!objects.matches(u"/home/project/build/main.obj"));
+    QVERIFY(!objects.matches(u"/home/project/build/main.O"));
+
+    const PathGlob tests("src/**/test_*.cpp");
+    QVERIFY(tests.matches(u"src/test_path.cpp"));
+    QVERIFY(tests.matches(u"src/core/sub/test_path.cpp"));
+    QVERIFY(!tests.matches(u"/src/test_path.cpp"));
+    QVERIFY(!tests.matches(u"src/core/path_test.cpp"));
+    QVERIFY(!tests.matches(u"lib/src/test_path.cpp"));
+
+    QVERIFY(PathGlob("/home/*").matches(u"/home/file"));
+    QVERIFY(!PathGlob("/home/*").matches(u"/home/folder/file"));
+    QVERIFY(!PathGlob("/home/*").matches(u"home/file"));
+    QVERIFY(!PathGlob("*/file").matches(u"/file"));
+    QVERIFY(PathGlob("**").matches(u"/any/path"));
+    QVERIFY(PathGlob("/home/**").matches(u"/home/folder/file"));
+    QVERIFY(PathGlob("a**b").matches(u"a_b"));
+    QVERIFY(!PathGlob("a**b").matches(u"a/b"));
+
+    QVERIFY(PathGlob("file?.txt").matches(u"file1.txt"));
+    QVERIFY(!PathGlob("file?.txt").matches(u"file.txt"));
+    QVERIFY(PathGlob("file[0-9].txt").matches(u"file7.txt"));
+    QVERIFY(!PathGlob("file[0-9].txt").matches(u"fileA.txt"));
+    QVERIFY(PathGlob("file[!0-9].txt").matches(u"fileA.txt"));
+    QVERIFY(PathGlob("file[^0-9].txt").matches(u"fileA.txt"));
+    QVERIFY(PathGlob("[*]file").matches(u"*file"));
+    QVERIFY(!PathGlob("[*]file").matches(u"xfile"));
+    QVERIFY(PathGlob("[]]").matches(u"]"));
+    QVERIFY(PathGlob("[abc").matches(u"[abc"));
+    QVERIFY(PathGlob("*a*b*c").matches(u"xaxbxaxbxc"));
+
+    const PathGlob insensitive("**/*.TXT", Qt::CaseInsensitive);
+    QVERIFY(insensitive.matches(u"/folder/file.txt"));
+    QVERIFY(insensitive.matches(u"/folder/FILE.Txt"));
+    QVERIFY(PathGlob("[A-Z]*", Qt::CaseInsensitive).matches(u"file"));
+    QVERIFY(!PathGlob("[A-Z]*").matches(u"file"));
+    QCOMPARE(insensitive.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(insensitive.pattern(), "**/*.TXT");
+
+    QVERIFY(PathGlob().isEmpty());
+    QVERIFY(PathGlob().matches(u""));
+    QVERIFY(!PathGlob().matches(u"file"));
+}
+
+void test_pathstr::test_filterByGlob()
+{
+    using namespace pathstr;
+    const QStringList paths = batchPaths();
+    const PathGlob glob("/root/folder1*/*.t*");
+
+    QStringList expected;
+    for (const QString &path : paths) {
+        if (glob.matches(path))
+            expected.append(path);
+    }
+
+    QVERIFY(!expected.isEmpty());
+    QCOMPARE(filterByGlob(paths, glob, 4), expected);
+    QCOMPARE(filterByGlob(paths, glob, 1), expected);
+    QVERIFY(filterByGlob(paths, PathGlob("*.zip")).isEmpty());
+}
+
+void test_pathstr::test_RootSet()
+{
+    using namespace pathstr;
+    RootSet roots({ "/home/user", "/home/user/projects/", "/srv", "C:/data" });
+    QCOMPARE(roots.size(), 4);
+    QCOMPARE(roots.insert("/srv/"), 2);
+    QCOMPARE(roots.size(), 4);
+    QCOMPARE(roots.root(1), "/home/user/projects/");
+    QVERIFY(roots.root(10).isNull());
+
+    QStringView rel;
+    QCOMPARE(roots.find(u"/home/user/projects/pathstr/README.md", &rel), 1);
+    QCOMPARE(rel, u"pathstr/README.md");
+    QCOMPARE(roots.find(u"/home/user/file.txt", &rel), 0);
+    QCOMPARE(rel, u"file.txt");
+    QCOMPARE(roots.find(u"/home/user/projects", &rel), 0);
+    QCOMPARE(rel, u"projects");
+    QCOMPARE(roots.find(u"/home/user/projects/", &rel), 1);
+    QVERIFY(rel.isEmpty() && !rel.isNull());
+    QCOMPARE(roots.find(u"C:/data/file", &rel), 3);
+    QCOMPARE(rel, u"file");
+    QCOMPARE(roots.find(u"/home/username/file"), -1);
+    QCOMPARE(roots.find(u"/home/user", &rel), -1);
+    QVERIFY(rel.isNull());
+    QCOMPARE(roots.find(u""), -1);
+
+    // "/" and the empty root
+    QCOMPARE(roots.insert("/"), 4);
+    QCOMPARE(roots.find(u"/etc/hosts", &rel), 4);
+    QCOMPARE(rel, u"etc/hosts");
+    QCOMPARE(roots.find(u"etc/hosts"), -1);
+    QCOMPARE(roots.insert(""), 5);
+    QCOMPARE(roots.find(u"etc/hosts", &rel), 5);
+    QCOMPARE(rel, u"etc/hosts");
+
+    // the same as relativePath() against the deepest root
+    const QStringList rootList { "/root", "/root/folder1", "/root/folder1/", "/root/folder12/sub", "/root/folder3/" };
+    const RootSet set(rootList);
+    for (const QString &path : batchPaths()) {
+        int expected = -1;
+        for (int i = 0; i < rootList.size(); ++i) {
+            if (!relativePathView(rootList.at(i), path).isNull()
+                && (expected == -1 || rootList.at(i).size() > rootList.at(expected).size()))
+                expected = i;
+        }
+
+        QCOMPARE(set.find(path, &rel) == -1, expected == -1);
+        if (expected != -1)
+            QCOMPARE(rel, relativePathView(rootList.at(expected), path));
+    }
+}
+
+void test_pathstr::test_relativePathsRootSet()
+{
+    using namespace pathstr;
+    const QStringList paths = batchPaths();
+    const RootSet roots({ "/root/folder1", "/root/folder2/", "/root/folder3/sub" });
+
+    QVector<int> indexes;
+    const QStringList result = relativePaths(roots, paths, 4, &indexes);
+    QCOMPARE(result.size(), paths.size());
+    QCOMPARE(indexes.size(), paths.size());
+
+    for (int i = 0; i < paths.size(); ++i) {
+        QStringView rel;
+        QCOMPARE(indexes.at(i), roots.find(paths.at(i), &rel));
+        QCOMPARE(result.at(i), rel.toString());
+        QCOMPARE(result.at(i).isNull(), rel.isNull());
+    }
+
+    QCOMPARE(relativePaths(roots, paths, 1), result);
+}
+
+void test_pathstr::test_comparePaths()
+{
+    using namespace pathstr;
+    QVERIFY(comparePaths(u"/a", u"/a/z") < 0);
+    QVERIFY(comparePaths(u"/a/z", u"/a-b") < 0);
+    QVERIFY(comparePaths(u"/a-b", u"/ab") < 0);
+    QVERIFY(comparePaths(u"/ab", u"/a") > 0);
+    QVERIFY(comparePaths(u"/a/", u"/a") > 0);
+    QCOMPARE(comparePaths(u"/a/b", u"/a/b"), 0);
+    QCOMPARE(comparePaths(u"", u""), 0);
+
+    // the same order of UTF-8 paths
+    QVERIFY(core::comparePaths(std::string_view("/a/z"), std::string_view("/a-b")) < 0);
+    QVERIFY(core::comparePaths(std::string_view("/a/\xc3\xa9"), std::string_view("/a/z")) > 0);
+}
+
+void test_pathstr::test_diffSnapshots()
+{
+    using namespace pathstr;
+    const QStringList previous { "/b/y", "/a/file", "/b/x/2", "/b/x/1", "/c" };
+    const QStringList current { "/a/new", "/b/y", "/a/file", "/d" };
+
+    SnapshotDiff diff = diffSnapshots(previous, current);
+    QCOMPARE(diff.added, QStringList({ "/a/new", "/d" }));
+    QCOMPARE(diff.removed, QStringList({ "/c" }));
+    QCOMPARE(diff.removedFolders, QStringList({ "/b/x" }));
+
+    // the folder entry itself is a part of the removed folder
+    diff = diffSnapshots({ "/a/x", "/b", "/b/1", "/b/2" }, { "/a/x" });
+    QVERIFY(diff.removed.isEmpty());
+    QCOMPARE(diff.removedFolders, QStringList({ "/b" }));
+
+    // the topmost folder left empty
+    diff = diffSnapshots({ "/a/x", "/b/c/d/1", "/b/c/2" }, { "/a/x" });
+    QCOMPARE(diff.removedFolders, QStringList({ "/b" }));
+
+    diff = diffSnapshots({ "/a/1", "/a/2" }, {});
+    QCOMPARE(diff.removedFolders, QStringList({ "/" }));
+
+    diff = diffSnapshots({ "C:/a/1", "C:/b" }, { "C:/b", "C:/b" });
+    QCOMPARE(diff.removedFolders, QStringList({ "C:/a" }));
+
+    // a file replaced by a folder
+    diff = diffSnapshots({ "/a/x" }, { "/a/x/1" });
+    QCOMPARE(diff.removed, QStringList({ "/a/x" }));
+    QCOMPARE(diff.added, QStringList({ "/a/x/1" }));
+
+    // null and empty paths in both snapshots: equal to each other, sorted first
+    diff = diffSortedSnapshots({ QString(), "/a/file", "/b/x" }, { "", "/a/file", "/a/new" });
+    QCOMPARE(diff.added, QStringList({ "/a/new" }));
+    QVERIFY(diff.removed.isEmpty());
+    QCOMPARE(diff.removedFolders, QStringList({ "/b" }));
+
+    diff = diffSnapshots({ "/a/file", "" }, { QString(), "/a/file" });
+    QVERIFY(diff.added.isEmpty() && diff.removed.isEmpty() && diff.removedFolders.isEmpty());
+
+    diff = diffSortedSnapshots({ QString(), "/a/file" }, { "/a/file" });
+    QCOMPARE(diff.removed.size(), 1);
+    QVERIFY(diff.removed.first().isEmpty());
+
+    diff = diffSortedSnapshots({ "/a/file" }, { QString(), "/a/file", "/a/new" });
+    QCOMPARE(diff.added.size(), 2);
+    QVERIFY(diff.added.first().isEmpty());
+    QCOMPARE(diff.added.last(), QString("/a/new"));
+
+    // the parallel merge gives the same result
+    QStringList before;
+    QStringList after;
+    for (const QString &path : batchPaths())
+        before.append(path + QString::number(before.size()));
+
+    for (int i = 0; i < before.size(); ++i) {
+        if (before.at(i).startsWith("/root/folder7/"))
+            continue;
+        if (i % 5 != 0)
+            after.append(before.at(i));
+        if (i % 7 == 0)
+            after.append(before.at(i) + "_new");
+    }
+
+    const SnapshotDiff serial = diffSnapshots(before, after, 1);
+    const SnapshotDiff parallel = diffSnapshots(before, after, 4);
+    QVERIFY(serial.removedFolders.contains("/root/folder7"));
+    QVERIFY(!serial.added.isEmpty() && !serial.removed.isEmpty());
+    QCOMPARE(parallel.added, serial.added);
+    QCOMPARE(parallel.removed, serial.removed);
+    QCOMPARE(parallel.removedFolders, serial.removedFolders);
+}
+
+void test_pathstr::test_sortPaths()
+{
+    using namespace pathstr;
+    QStringList list { "/b", "/a/z", "/B/y" };
+    sortPaths(list);
+    QCOMPARE(list, QStringList({ "/B/y", "/a/z", "/b" }));
+    sortPaths(list, Qt::CaseInsensitive);
+    QCOMPARE(list, QStringList({ "/a/z", "/b", "/B/y" }));
+
+    list = QStringList { "/f/10.txt", "/f/2.txt", "/f/1/x", "/f/02.txt", "/f/1", "/f/x" };
+    sortPaths(list, Qt::CaseSensitive, true);
+    QCOMPARE(list, QStringList({ "/f/1", "/f/1/x", "/f/2.txt", "/f/02.txt", "/f/10.txt", "/f/x" }));
+    sortPaths(list);
+    QCOMPARE(list, QStringList({ "/f/02.txt", "/f/1", "/f/1/x", "/f/10.txt", "/f/2.txt", "/f/x" }));
+
+    QVERIFY(comparePaths(u"/a/File", u"/a/file", Qt::CaseInsensitive) == 0);
+    QVERIFY(comparePaths(u"/a/File", u"/a/file", Qt::CaseSensitive) < 0);
+    QVERIFY(comparePaths(u"v9.1", u"v10.0", Qt::CaseSensitive, true) < 0);
+    QVERIFY(comparePaths(u"v007", u"v7", Qt::CaseSensitive, true) == 0);
+
+    // the same as the stable sort by the comparison, parallel too
+    QStringList paths;
+    const QStringList names = { "File", "file", "FILE10", "file9", "a-b", "a", "ab/c", "a/b", "x.TXT", "\u00C9t\u00E9" };
+    for (int i = 0; i < 20000; ++i) {
+        paths.append("/root/" + names.at(i % names.size()) + '/' + names.at(i / 7 % names.size())
+                     + QString::number(i % 113));
+    }
+
+    for (const Qt::CaseSensitivity cs : { Qt::CaseSensitive, Qt::CaseInsensitive }) {
+        for (const bool natural : { false, true }) {
+            QVector<int> expected(paths.size());
+            std::iota(expected.begin(), expected.end(), 0);
+            std::stable_sort(expected.begin(), expected.end(), [&](int i, int j) {
+                return comparePaths(paths.at(i), paths.at(j), cs, natural) < 0;
+            });
+
+            QCOMPARE(sortedPathIndexes(paths, cs, natural, 1), expected);
+            QCOMPARE(sortedPathIndexes(paths, cs, natural, 4), expected);
+        }
+    }
+
+    QStringList sorted = paths;
+    sortPaths(sorted, Qt::CaseSensitive, false, 3);
+    for (int i = 1; i < sorted.size(); ++i)
+        QVERIFY(comparePaths(sorted.at(i - 1), sorted.at(i)) <= 0);
+
+    QStringList empty;
+    sortPaths(empty);
+    QVERIFY(empty.isEmpty());
+}
+
+void test_pathstr::test_PathKey()
+{
+    using namespace pathstr;
+    const PathKey key;
+    QVERIFY(key.equal(u"C:\\dir\\file", u"c:/dir/file/"));
+    QVERIFY(key.equal(u"C:\\dir\\file", u"C:/dir//file"));
+    QVERIFY(key.equal(u"/folder//", u"/folder"));
+    QVERIFY(key.equal(u"C:/", u"c:"));
+    QVERIFY(key.equal(u"//", u"/"));
+    QVERIFY(!key.equal(u"/", u""));
+    QVERIFY(!key.equal(u"C:/dir/File", u"C:/dir/file"));
+    QVERIFY(!key.equal(u"C:/dir/./file", u"C:/dir/file"));
+    QVERIFY(!key.equal(u"C:/dir", u"C:/dir/file"));
+    QCOMPARE(key.hash(u"C:\\dir\\file"), key.hash(u"c:/dir//file/"));
+    QCOMPARE(key(u"/a/b"), pathHash(u"/a/b/"));
+
+    // the options one by one
+    QVERIFY(pathsEqual(u"/a/b", u"/a/b", PathKey::Exact));
+    QVERIFY(!pathsEqual(u"/a\\b", u"/a/b", PathKey::Exact));
+    QVERIFY(pathsEqual(u"/a\\b", u"/a//b", PathKey::SeparatorInsensitive));
+    QVERIFY(!pathsEqual(u"/a/b/", u"/a/b", PathKey::SeparatorInsensitive));
+    QVERIFY(pathsEqual(u"/a/b/", u"/a/b", PathKey::TrailingSeparatorInsensitive));
+    QVERIFY(!pathsEqual(u"/a/b//", u"/a/b", PathKey::TrailingSeparatorInsensitive)); // as chopSep()
+    QVERIFY(pathsEqual(u"d:/a", u"D:/a", PathKey::DriveCaseInsensitive));
+    QVERIFY(!pathsEqual(u"d:/a", u"D:/A", PathKey::DriveCaseInsensitive));
+    QVERIFY(!pathsEqual(u"da:/a", u"Da:/a", PathKey::DriveCaseInsensitive));
+    QVERIFY(pathsEqual(u"d:/a", u"D:/A", PathKey::CaseInsensitive));
+    QVERIFY(!pathsEqual(u"/\u00E9", u"/\u00C9", PathKey::CaseInsensitive));
+
+    // the equal paths have equal hashes, the different ones rarely do
+    const QStringList paths = batchPaths();
+    for (const int options : { int(PathKey::Default), int(PathKey::Exact), PathKey::Default | PathKey::CaseInsensitive }) {
+        const PathKey optKey(options);
+        for (const QString &path : paths) {
+            QString other = path;
+            if (options & PathKey::SeparatorInsensitive)
+                other.replace('/', "\\\\");
+            if (options & PathKey::CaseInsensitive)
+                other = other.toUpper();
+            QVERIFY(optKey.equal(path, other));
+            QCOMPARE(optKey.hash(path), optKey.hash(other));
+        }
+    }
+
+    std::vector<size_t> hashes;
+    for (int i = 0; i < 100000; ++i)
+        hashes.push_back(key.hash(QString("/root/folder/file" + QString::number(i))) & 0xFFFFFF);
+    std::sort(hashes.begin(), hashes.end());
+    QVERIFY(std::unique(hashes.begin(), hashes.end()) - hashes.begin() > 99000);
+}
+
+void test_pathstr::test_PathSet()
+{
+    using namespace pathstr;
+    PathSet set;
+    QVERIFY(set.isEmpty());
+    QCOMPARE(set.find(u"/a"), -1);
+    QCOMPARE(set.insert("C:\\dir\\file"), 0);
+    QCOMPARE(set.insert("c:/dir/file/"), 0);
+    QCOMPARE(set.insert("/dir/file"), 1);
+    QCOMPARE(set.find(u"C:/dir//file"), 0);
+    QVERIFY(set.contains(u"/dir\\file\\"));
+    QVERIFY(!set.contains(u"/dir/file2"));
+    QCOMPARE(set.path(0), QString("C:\\dir\\file"));
+    QCOMPARE(set.path(5), QString());
+    QCOMPARE(set.size(), 2);
+
+    const PathSet exact({ "/a/b", "/a/b/", "/a\\b", "/a/b" }, PathKey::Exact);
+    QCOMPARE(exact.paths(), QStringList({ "/a/b", "/a/b/", "/a\\b" }));
+
+    // the same as the normalized strings
+    const QStringList paths = batchPaths();
+    QStringList normalized;
+    for (const QString &path : paths)
+        normalized.append(chopSep(QString(path).replace('\\', '/')));
+    normalized.removeDuplicates();
+
+    const PathSet unique(paths);
+    QCOMPARE(unique.size(), normalized.size());
+    for (int i = 0; i < unique.size(); ++i)
+        QCOMPARE(unique.find(normalized.at(i)), i);
+}
+
+void test_pathstr::test_profile()
+{
+    using namespace pathstr;
+    typedef profile::Function Function;
+
+    QCOMPARE(profile::sizeBucket(0), 0);
+    QCOMPARE(profile::sizeBucket(1), 1);
+    QCOMPARE(profile::sizeBucket(3), 2);
+    QCOMPARE(profile::sizeBucket(4), 3);
+    QCOMPARE(profile::sizeBucket(1 << 20), profile::s_sizeBuckets - 1);
+    QCOMPARE(profile::sizeBucketName(2), QByteArray("2-3"));
+    QCOMPARE(profile::sizeBucketName(profile::s_sizeBuckets - 1), QByteArray("65536+"));
+    QCOMPARE(QByteArray(profile::functionName(Function::lowerSuffixView)), QByteArray("lowerSuffixView"));
+
+    profile::reset();
+    QCOMPARE(entryName("/folder/file.txt"), QString("file.txt"));
+    QCOMPARE(joinPath("/folder", "file"), QString("/folder/file"));
+    QCOMPARE(normalize(QString("/a//b")), QString("/a/b"));
+
+    profile::Snapshot snapshot = profile::snapshot();
+
+    if (!profile::isAvailable()) {
+        QCOMPARE(snapshot[Function::entryName].calls, quint64(0));
+        QCOMPARE(snapshot.toJson(), QByteArray("{ \"sample_interval\": 64, \"functions\": [] }\n"));
+        return;
+    }
+
+    QCOMPARE(snapshot[Function::entryName].calls, quint64(1));
+    QCOMPARE(snapshot[Function::entryName].sizes[profile::sizeBucket(16)], quint64(1));
+    QCOMPARE(snapshot[Function::joinPath].calls, quint64(1));
+    QCOMPARE(snapshot[Function::normalize].calls, quint64(1));
+    QCOMPARE(snapshot[Function::comparePaths].calls, quint64(0));
+
+    // nested calls are a part of the outer one
+    QCOMPARE(snapshot[Function::endsWithSep].calls, quint64(0));
+    QCOMPARE(snapshot[Function::isNormalized].calls, quint64(0));
+
+    // the first call is timed, then every s_sampleInterval-th
+    for (int i = 0; i < profile::s_sampleInterval; ++i)
+        QVERIFY(isAbsolute(QStringView(u"/a")));
+    QCOMPARE(profile::snapshot()[Function::isAbsolute].sampledCalls, quint64(1));
+
+    const QByteArray json = profile::snapshot().toJson();
+    QVERIFY(json.contains("{ \"name\": \"entryName\", \"calls\": 1, "));
+    QVERIFY(json.contains("\"sizes\": { \"16-31\": 1 }"));
+    QVERIFY(!json.contains("comparePaths"));
+
+    // the counter is read when a call starts and ends
+    profile::reset();
+    profile::setAllocationCounter([]() -> quint64 {
+        static quint64 s_count = 0;
+        return s_count++;
+    });
+    setSuffix("file.txt", "zip");
+    setSuffix("file", "zip");
+    profile::setAllocationCounter(nullptr);
+    QCOMPARE(profile::snapshot()[Function::setSuffix].allocations, quint64(2));
+
+    // the counters of the finished threads are kept
+    profile::reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 100; ++i)
+                parentFolder("/folder/file");
+        });
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    QCOMPARE(profile::snapshot()[Function::parentFolder].calls, quint64(400));
+
+    profile::setEnabled(false);
+    parentFolder("/folder/file");
+    profile::setEnabled(true);
+    QCOMPARE(profile::snapshot()[Function::parentFolder].calls, quint64(400));
+
+    profile::reset();
+    QCOMPARE(profile::snapshot()[Function::parentFolder].calls, quint64(0));
+}
+
+// The paths relative to the <root>, in the path order
+static QStringList relativeSorted(const QString &root, QStringList paths)
+{
+    for (QString &path : paths)
+        path = pathstr::relativePath(root, path);
+
+    pathstr::sortPaths(paths);
+    return paths;
+}
+
+void test_pathstr::test_walk()
+{
+    using namespace pathstr;
+    const QTemporaryDir dir;
+    const QString root = dir.path();
+    QVERIFY(QDir(root).mkpath("a/b/c"));
+    QVERIFY(QDir(root).mkpath("a/node_modules/x"));
+    QVERIFY(QDir(root).mkpath("d"));
+    for (const QString &file : QStringList { "top.txt", "a/file.txt", "a/b/photo.JPG", "a/b/папка.txt",
+                                              "a/b/c/archive.tar.gz", "a/node_modules/x/lib.js", "d/.hidden" })
+        writeFile(root + '/' + file, "data");
+
+    QStringList all = { "a", "a/b", "a/b/c", "a/b/c/archive.tar.gz", "a/b/photo.JPG", "a/b/папка.txt",
+                        "a/file.txt", "a/node_modules", "a/node_modules/x", "a/node_modules/x/lib.js",
+                        "d", "d/.hidden", "top.txt" };
+    sortPaths(all);
+
+    QCOMPARE(relativeSorted(root, walkPaths(root)), all);
+    QCOMPARE(relativeSorted(root, walkPaths(root + '/')), all);
+    QVERIFY(walkPaths(root).contains(root + "/a/b/c"));
+
+    WalkOptions options;
+    options.threads = 1;
+    QCOMPARE(relativeSorted(root, walkPaths(root, options)), all);
+
+    options.maxDepth = 0;
+    QCOMPARE(relativeSorted(root, walkPaths(root, options)), QStringList({ "a", "d", "top.txt" }));
+    options.maxDepth = 1;
+    QCOMPARE(relativeSorted(root, walkPaths(root, options)),
+             QStringList({ "a", "a/b", "a/file.txt", "a/node_modules", "d", "d/.hidden", "top.txt" }));
+
+    // filters
+    const ExtensionSet extensions({ "txt", "tar.gz" });
+    options = WalkOptions();
+    options.extensions = &extensions;
+    options.folders = false;
+    QCOMPARE(relativeSorted(root, walkPaths(root, options)),
+             QStringList({ "a/b/c/archive.tar.gz", "a/b/папка.txt", "a/file.txt", "top.txt" }));
+
+    options = WalkOptions();
+    options.files = false;
+    options.prune = [](const WalkEntry &entry) { return entry.name == u"node_modules"; };
+    QCOMPARE(relativeSorted(root, walkPaths(root, options)), QStringList({ "a", "a/b", "a/b/c", "d" }));
+
+    // the callback, from all workers
+    std::mutex mutex;
+    QStringList paths;
+    int folders = 0;
+    bool consistent = true;
+    const bool walked = walk(root, [&](const WalkEntry &entry) {
+        const std::lock_guard<std::mutex> lock(mutex);
+        paths.append(entry.path.toString());
+        folders += entry.isFolder();
+        consistent &= (entry.name == entryNameView(entry.path))
+                      && (entry.depth == relativePath(root, entry.path.toString()).count(s_sep));
+    });
+    QVERIFY(walked);
+    QCOMPARE(relativeSorted(root, paths), all);
+    QCOMPARE(folders, 6);
+    QVERIFY(consistent);
+
+    // the queue
+    {
+        WalkQueue queue(root);
+        WalkEntry entry;
+        paths.clear();
+        while (queue.next(entry))
+            paths.append(entry.path.toString());
+        QVERIFY(queue.isOk());
+        QCOMPARE(relativeSorted(root, paths), all);
+    }
+    {
+        // stopped by the destructor
+        WalkQueue queue(root);
+        WalkEntry entry;
+        QVERIFY(queue.next(entry));
+    }
+
+    // no root folder
+    QVERIFY(!walk(root + "/missing", [](const WalkEntry &) {}));
+    QVERIFY(!walk(root + "/top.txt", [](const WalkEntry &) {}));
+    QVERIFY(walkPaths(QString()).isEmpty());
+    WalkQueue missing(root + "/missing");
+    WalkEntry entry;
+    QVERIFY(!missing.next(entry));
+    QVERIFY(!missing.isOk());
+}
+
+void test_pathstr::test_commonAncestor()
+{
+    using namespace pathstr;
+    QCOMPARE(commonAncestorView(u"/folder/folder2/file", u"/folder/file2"), u"/folder");
+    QCOMPARE(commonAncestorView(u"/folder/file", u"/folder/file"), u"/folder/file");
+    QCOMPARE(commonAncestorView(u"/folder", u"/folder/file"), u"/folder");
+    QCOMPARE(commonAncestorView(u"/folder/file", u"/folder/"), u"/folder");
+    QCOMPARE(commonAncestorView(u"/folder/", u"/folder/file"), u"/folder");
+    QCOMPARE(commonAncestorView(u"/folder/file", u"/folder/file2"), u"/folder");
+    QCOMPARE(commonAncestorView(u"/folder//file", u"/folder/file"), u"/folder//file");
+    QCOMPARE(commonAncestorView(u"/folder/file", u"/folder//file"), u"/folder/file");
+    QCOMPARE(commonAncestorView(u"/a//b/c", u"/a/b\\d"), u"/a//b");
+    QCOMPARE(commonAncestorView(u"/a//b", u"/a/c"), u"/a");
+    QCOMPARE(commonAncestorView(u"/folder//", u"/folder/file"), u"/folder");
+    QCOMPARE(commonAncestorView(u"//folder/a", u"/folder/b"), u"//folder");
+    QCOMPARE(commonAncestorView(u"/folder\\file/a", u"/folder/file/b"), u"/folder\\file");
+    QCOMPARE(commonAncestorView(u"/file", u"/file2"), u"/");
+    QCOMPARE(commonAncestorView(u"/", u"/folder"), u"/");
+    QCOMPARE(commonAncestorView(u"folder/file", u"folder/file2"), u"folder");
+    QVERIFY(commonAncestorView(u"folder", u"folder2").isNull());
+    QVERIFY(commonAncestorView(u"", u"").isNull());
+    QVERIFY(commonAncestorView(u"/folder", u"folder").isNull());
+
+    // drive roots, kept as in the first path
+    QCOMPARE(commonAncestorView(u"C:/folder/file", u"c:\\folder\\file2"), u"C:/folder");
+    QCOMPARE(commonAncestorView(u"c:\\folder", u"C:/folder2"), u"c:\\");
+    QCOMPARE(commonAncestorView(u"C:/", u"C:/folder"), u"C:/");
+    QCOMPARE(commonAncestorView(u"C:folder", u"C:file"), u"C:");
+    QVERIFY(commonAncestorView(u"C:/folder", u"D:/folder").isNull());
+    QVERIFY(commonAncestorView(u"C:/folder", u"C:folder").isNull());
+    QVERIFY(commonAncestorView(u"C:/folder", u"/folder").isNull());
+    QVERIFY(core::commonAncestor<core::PosixPolicy>(std::string_view("C:/folder/a"), std::string_view("C:/folder/b")) == "C:/folder");
+    QVERIFY(core::commonAncestor<core::WindowsPolicy>(std::string_view("\\dir\\a"), std::string_view("/dir/b")) == "\\dir");
+    QVERIFY(core::commonAncestor<core::PosixPolicy>(std::string_view("/dir\\a"), std::string_view("/dir\\b")) == "/");
+
+    // lists
+    QVERIFY(commonAncestor(QStringList()).isNull());
+    QCOMPARE(commonAncestor({ "/folder/" }), QString("/folder"));
+    QCOMPARE(commonAncestor({ "/home/user/photos/img.jpg", "/home/user/docs/", "/home/user/docs/file.txt" }), QString("/home/user"));
+    QVERIFY(commonAncestor({ "/home/file", "/home/file2", "C:/file" }).isNull());
+    QCOMPARE(commonAncestor({ "/home//user/a", "/home/user/b", "/home/user//c/d" }), QString("/home//user"));
+
+    const QStringList single { "/folder/file" };
+    QVERIFY(commonAncestor(single).constData() == single.first().constData());
+
+    // the parallel reduction: the same as in a single thread
+    QStringList paths;
+    for (int i = 0; i < 200000; ++i)
+        paths.append(QString("/data/set/dir%1/file%2.txt").arg(i % 97).arg(i));
+
+    QCOMPARE(commonAncestor(paths, 4), QString("/data/set"));
+    QCOMPARE(commonAncestor(paths, 4), commonAncestor(paths, 1));
+
+    paths.append("/data/other");
+    QCOMPARE(commonAncestor(paths, 4), QString("/data"));
+
+    paths[100000] = "C:/data";
+    QVERIFY(commonAncestor(paths, 4).isNull());
+}
+
+void test_pathstr::test_PathBuffer()
+{
+    using namespace pathstr;
+    PathBuffer buffer;
+    QVERIFY(buffer.isEmpty());
+    buffer.append(u"/folder/file.txt");
+    buffer.append({ u"/folder", u"/", u"file2" });
+    buffer.append(QStringView());
+    buffer.appendUtf8("/folder/папка/");
+    buffer.appendUtf8("C:/file");
+    QCOMPARE(buffer.size(), 5);
+    QCOMPARE(buffer.at(0), u"/folder/file.txt");
+    QCOMPARE(buffer.at(1), u"/folder/file2");
+    QVERIFY(buffer.at(2).isEmpty());
+    QCOMPARE(buffer[3].toString(), QString::fromUtf8("/folder/папка/"));
+    QCOMPARE(buffer.dataSize(), qint64(16 + 13 + 0 + 14 + 7));
+    QCOMPARE(buffer.toStringList(),
+             QStringList({ "/folder/file.txt", "/folder/file2", "", QString::fromUtf8("/folder/папка/"), "C:/file" }));
+    QCOMPARE(int(std::count_if(buffer.begin(), buffer.end(), [](QStringView path) { return path.startsWith(u"/folder"); })), 3);
+
+    // a random access iterator
+    const PathBuffer::const_iterator first = buffer.begin();
+    QCOMPARE(first->size(), 16);
+    QCOMPARE(*(2 + first), buffer.at(2));
+    QVERIFY(first < buffer.end() && buffer.end() > first && first <= first && first >= first);
+    QCOMPARE(int(std::distance(first, buffer.end())), 5);
+    const PathBuffer sorted(QStringList({ "/a", "/b/c", "/b/d", "/e" }));
+    QCOMPARE(int(std::lower_bound(sorted.begin(), sorted.end(), QStringView(u"/b/d")) - sorted.begin()), 2);
+    QVERIFY(buffer.memoryUsage() >= buffer.dataSize() * 2);
+
+    buffer.clear();
+    QVERIFY(buffer.isEmpty());
+    QCOMPARE(buffer.dataSize(), qint64(0));
+
+    // the batch functions give the results of the list ones
+    const QStringList paths = batchPaths();
+    const PathBuffer pathBuffer(paths);
+    QCOMPARE(pathBuffer.toStringList(), paths);
+
+    const PathBuffer relative = relativePaths("/root/folder3", pathBuffer, 4);
+    const PathBuffer suffixed = setSuffixes(pathBuffer, "zip", 4);
+    const PathBuffer names = entryNames(pathBuffer, 4);
+    QCOMPARE(relative.size(), paths.size());
+    QCOMPARE(suffixed.size(), paths.size());
+    QCOMPARE(names.size(), paths.size());
+    for (int i = 0; i < paths.size(); ++i) {
+        QCOMPARE(relative.at(i), QStringView(relativePath("/root/folder3", paths.at(i))));
+        QCOMPARE(suffixed.at(i), QStringView(setSuffix(paths.at(i), "zip")));
+        QCOMPARE(names.at(i), entryNameView(paths.at(i)));
+    }
+
+    for (const char *suf : { ".zip", "", "." }) {
+        const PathBuffer result = setSuffixes(PathBuffer({ "/folder/file", "/folder/file.", "/folder/file.txt" }), suf);
+        QCOMPARE(result.toStringList(),
+                 QStringList({ setSuffix("/folder/file", suf), setSuffix("/folder/file.", suf), setSuffix("/folder/file.txt", suf) }));
+    }
+
+    const ExtensionSet extensions({ "txt", "tar.gz" });
+    QCOMPARE(filterByExtension(pathBuffer, extensions, 4).toStringList(), filterByExtension(paths, extensions, 4));
+    QVERIFY(entryNames(PathBuffer()).isEmpty());
+
+    // from a file, and as a sink of the streaming functions
+    const QTemporaryDir dir;
+    const QString fileName = dir.filePath("list.txt");
+    writeFile(fileName, "/folder/file.txt\r\n\n/folder/папка/\nC:/file");
+
+    bool ok = false;
+    const PathBuffer loaded = PathBuffer::fromFile(fileName, &ok);
+    QVERIFY(ok);
+    QCOMPARE(loaded.toStringList(),
+             QStringList({ "/folder/file.txt", QString::fromUtf8("/folder/папка/"), "C:/file" }));
+
+    PathBuffer sink;
+    core::relativePaths(core::MappedPathList(fileName.toStdString()), "/folder", sink);
+    QCOMPARE(sink.toStringList(), QStringList({ "file.txt", QString::fromUtf8("папка/") }));
+
+    QVERIFY(PathBuffer::fromFile(dir.filePath("missing.txt"), &ok).isEmpty());
+    QVERIFY(!ok);
+}
+
+void test_pathstr::test_PathAggregator()
+{
+    using namespace pathstr;
+    PathAggregator agg;
+    agg.add(u"/photos/2021/img.JPG", 2048);
+    agg.add(u"/photos/2021/img2.jpg", 1000);
+    agg.add(u"/photos/notes.txt", 100);
+    agg.add(u"/photos/backup.tar.gz", 0);
+    agg.add(u"/photos/README", 5);
+    agg.add(u"file.txt", 7);
+
+    QCOMPARE(agg.total().count, qint64(6));
+    QCOMPARE(agg.total().total, qint64(3160));
+    QCOMPARE(agg.extensionCount(), 4);
+    QCOMPARE(agg.extension(u"jpg").count, qint64(2));
+    QCOMPARE(agg.extension(u".JPG").total, qint64(3048));
+    QCOMPARE(agg.extension(u"jpg").histogram[PathAggregator::histogramBucket(2048)], qint64(1));
+    QCOMPARE(agg.extension(u"tar.gz").histogram[0], qint64(1));
+    QCOMPARE(agg.extension(u"txt").total, qint64(107));
+    QCOMPARE(agg.extension(u"").total, qint64(5));
+    QCOMPARE(agg.extension(u"gz").count, qint64(0));
+
+    QCOMPARE(PathAggregator::histogramBucket(-1), 0);
+    QCOMPARE(PathAggregator::histogramBucket(1), 1);
+    QCOMPARE(PathAggregator::histogramBucket(3), 2);
+    QCOMPARE(PathAggregator::histogramBucket(1024), 11);
+    QCOMPARE(PathAggregator::histogramBucket(std::numeric_limits<qint64>::max()), 63);
+
+    const PathTree &folders = agg.folders();
+    QCOMPARE(agg.direct(folders.find(u"/photos")).total, qint64(105));
+    QCOMPARE(agg.recursive(folders.find(u"/photos")).total, qint64(3153));
+    QCOMPARE(agg.recursive(folders.find(u"/photos")).count, qint64(5));
+    QCOMPARE(agg.direct(folders.find(u"/photos/2021")).count, qint64(2));
+    QCOMPARE(agg.direct(folders.find(u"/")).count, qint64(0));
+    QCOMPARE(agg.recursive(folders.find(u"/")).total, qint64(3153));
+    QCOMPARE(agg.recursive(folders.find(u"/missing")).count, qint64(0));
+
+    // rolled up once, then summed up per call until the next rollUp()
+    agg.rollUp();
+    QCOMPARE(agg.recursive(folders.find(u"/photos")).total, qint64(3153));
+    QCOMPARE(agg.recursive(folders.find(u"/")).count, qint64(5));
+    agg.add(u"/photos/2021/raw/img.cr2", 10);
+    QCOMPARE(agg.recursive(folders.find(u"/photos")).total, qint64(3163));
+    QCOMPARE(agg.recursive(folders.find(u"/photos/2021/raw")).total, qint64(10));
+    agg.rollUp();
+    QCOMPARE(agg.recursive(folders.find(u"/photos")).total, qint64(3163));
+
+    // the parallel aggregation against the ancestors walked per path
+    QStringList paths;
+    QVector<qint64> values;
+    for (int i = 0; i < 20000; ++i) {
+        paths.append(QString("/data/d%1/s%2/file%3.%4").arg(i % 13).arg(i % 7).arg(i).arg((i % 3) ? QString("txt") : QString("TAR.gz")));
+        values.append(i);
+    }
+
+    QHash<QString, qint64> recursive;
+    QHash<QString, qint64> byExtension;
+    for (int i = 0; i < paths.size(); ++i) {
+        byExtension[completeSuffix(paths.at(i))] += values.at(i);
+        for (QString folder = parentFolder(paths.at(i)); ; folder = parentFolder(folder)) {
+            recursive[folder] += values.at(i);
+            if (isRoot(folder))
+                break;
+        }
+    }
+
+    const PathAggregator parallel = aggregate(paths, values, 4);
+    const PathAggregator single = aggregate(PathBuffer(paths), values, 1);
+    for (const PathAggregator *result : { &parallel, &single }) {
+        QCOMPARE(result->total().count, qint64(paths.size()));
+        QCOMPARE(result->folders().size(), recursive.size());
+        for (auto it = recursive.cbegin(); it != recursive.cend(); ++it)
+            QCOMPARE(result->recursive(result->folders().find(it.key())).total, it.value());
+        QCOMPARE(result->extensionCount(), byExtension.size());
+        for (auto it = byExtension.cbegin(); it != byExtension.cend(); ++it)
+            QCOMPARE(result->extension(it.key()).total, it.value());
+    }
+
+    QCOMPARE(aggregate(QStringList(), QVector<qint64>()).total().count, qint64(0));
 }
 
 QTEST_APPLESS_MAIN(test_pathstr)
@@ -0,0 +1,591 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#include "walk.h"
+#include "pathstr.h"
+#include "pathstr_p.h"
+#include "extensionset.h"
+#include <QFile>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <QDirIterator>
+#include <QFileInfo>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace pathstr {
+// Waiting for the work of the other threads: spinning first, then sleeping
+static void backoff(int idle)
+{
+    if (idle < 64)
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+/*** Folders ***/
+#ifndef _WIN32
+// An open folder; it's closed when the last of its subfolders is opened
+class Folder
+{
+public:
+    explicit Folder(int fd) : m_fd(fd) {}
+    ~Folder() { ::close(m_fd); }
+
+    Folder(const Folder &) = delete;
+    Folder &operator=(const Folder &) = delete;
+
+    int fd() const { return m_fd; }
+
+private:
+    int m_fd;
+};
+#else
+// Listed by the path
+class Folder
+{};
+#endif
+
+typedef std::shared_ptr<Folder> FolderRef;
+
+// A folder to read
+struct Task
+{
+    FolderRef parent; // null for the root folder
+    FolderRef folder; // already open (the root), or null
+    std::string name; // the native name in the parent
+    QString path;
+    int depth = 0;    // of its entries
+};
+
+static FolderRef openFolder(const Task &task)
+{
+#ifdef _WIN32
+    return std::make_shared<Folder>();
+#else
+    const int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC;
+    const int fd = task.parent ? ::openat(task.parent->fd(), task.name.c_str(), flags | O_NOFOLLOW)
+                               : ::open(QFile::encodeName(task.path).constData(), flags);
+
+    return (fd == -1) ? FolderRef() : std::make_shared<Folder>(fd);
+#endif
+}
+
+#ifndef _WIN32
+static WalkEntry::Type entryType(int fd, const char *name, unsigned char type)
+{
+    switch (type) {
+    case DT_DIR:
+        return WalkEntry::Folder;
+    case DT_REG:
+        return WalkEntry::File;
+    case DT_LNK:
+        return WalkEntry::SymLink;
+    case DT_UNKNOWN:
+        break;
+    default:
+        return WalkEntry::Other;
+    }
+
+    // not reported by the file system
+    struct stat st;
+    if (::fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+        return WalkEntry::Other;
+
+    if (S_ISDIR(st.st_mode))
+        return WalkEntry::Folder;
+    if (S_ISREG(st.st_mode))
+        return WalkEntry::File;
+    if (S_ISLNK(st.st_mode))
+        return WalkEntry::SymLink;
+
+    return WalkEntry::Other;
+}
+
+static inline bool isDotOrDotDot(const char *name)
+{
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+#ifdef __linux__
+struct LinuxDirent64
+{
+    quint64 ino;
+    qint64 off;
+    unsigned short reclen;
+    unsigned char type;
+    char name[1];
+};
+#endif
+
+/* Calls <func(name, type)> for every entry of the <folder> except "." and "..".
+ * The <buffer> is reused for the listings.
+ */
+template <typename Func>
+static void readFolder(const Folder &folder, const Task &, std::vector<quint64> &buffer, Func func)
+{
+#ifdef __linux__
+    if (buffer.empty())
+        buffer.resize(4096); // 32 KiB
+
+    for (;;) {
+        char *data = reinterpret_cast<char *>(buffer.data());
+        const long size = ::syscall(SYS_getdents64, folder.fd(), data, buffer.size() * sizeof(quint64));
+        if (size <= 0)
+            return;
+
+        for (long pos = 0; pos < size;) {
+            const LinuxDirent64 *dirent = reinterpret_cast<const LinuxDirent64 *>(data + pos);
+            pos += dirent->reclen;
+
+            if (!isDotOrDotDot(dirent->name))
+                func(dirent->name, entryType(folder.fd(), dirent->name, dirent->type));
+        }
+    }
+#else
+    // readdir() closes the fd of the DIR, the folder keeps its own
+    const int fd = ::dup(folder.fd());
+    DIR *dir = (fd == -1) ? nullptr : ::fdopendir(fd);
+    if (!dir) {
+        if (fd != -1)
+            ::close(fd);
+        return;
+    }
+
+    while (const dirent *entry = ::readdir(dir)) {
+        if (!isDotOrDotDot(entry->d_name))
+            func(entry->d_name, entryType(folder.fd(), entry->d_name, entry->d_type));
+    }
+
+    ::closedir(dir);
+    Q_UNUSED(buffer);
+#endif
+}
+
+// The <buffer> ends with the <name> after the <base>: the ASCII names are widened in place
+static void setName(QString &buffer, int base, const char *name)
+{
+    const int size = static_cast<int>(std::strlen(name));
+    buffer.resize(base + size);
+    char16_t *out = reinterpret_cast<char16_t *>(buffer.data()) + base;
+
+    for (int i = 0; i < size; ++i) {
+        const unsigned char ch = name[i];
+        if (ch > 0x7F) {
+            buffer.resize(base);
+            buffer.append(QFile::decodeName(name));
+            return;
+        }
+        out[i] = ch;
+    }
+}
+
+static inline std::string nativeName(const char *name)
+{
+    return name;
+}
+#else
+template <typename Func>
+static void readFolder(const Folder &, const Task &task, std::vector<quint64> &, Func func)
+{
+    QDirIterator it(task.path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const WalkEntry::Type type = info.isSymLink() ? WalkEntry::SymLink
+                                     : info.isDir()   ? WalkEntry::Folder
+                                     : info.isFile()  ? WalkEntry::File
+                                                      : WalkEntry::Other;
+        func(info.fileName(), type);
+    }
+}
+
+static void setName(QString &buffer, int base, const QString &name)
+{
+    buffer.resize(base);
+    buffer.append(name);
+}
+
+// The subfolders are opened by the path
+static inline std::string nativeName(const QString &)
+{
+    return std::string();
+}
+#endif
+
+/*** Walker ***/
+/* The workers: every one has a deque of the folders to read. The owner takes the last one
+ * (depth first, the parent folders are closed early), the others steal the first one
+ * (the shallowest: the largest part of the work). A <Sink> of each worker takes the entries.
+ */
+template <typename Sink>
+class Walker
+{
+public:
+    Walker(const WalkOptions &options, std::vector<Sink> &sinks, const std::atomic<bool> *cancelled)
+        : m_options(options)
+        , m_sinks(sinks)
+        , m_queues(new Queue[sinks.size()])
+        , m_cancelled(cancelled)
+    {}
+
+    bool run(const QString &rootFolder)
+    {
+        Task root;
+        root.path = rootFolder;
+        root.folder = rootFolder.isEmpty() ? FolderRef() : openFolder(root);
+        if (!root.folder)
+            return false;
+
+        push(0, std::move(root));
+
+        const int workers = static_cast<int>(m_sinks.size());
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (int i = 1; i < workers; ++i)
+            pool.emplace_back([this, i]() { work(i); });
+
+        work(0);
+
+        for (std::thread &thread : pool)
+            thread.join();
+
+        return true;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool cancelled() const
+    {
+        return m_cancelled && m_cancelled->load(std::memory_order_relaxed);
+    }
+
+    void push(int worker, Task &&task)
+    {
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+
+        Queue &queue = m_queues[worker];
+        const std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    bool take(int worker, Task &task)
+    {
+        const int workers = static_cast<int>(m_sinks.size());
+
+        for (int i = 0; i < workers; ++i) {
+            const int victim = (worker + i) % workers;
+            Queue &queue = m_queues[victim];
+            const std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty()) {
+                if (victim == worker) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void work(int worker)
+    {
+        QString buffer;
+        buffer.reserve(1024);
+        std::vector<quint64> listing;
+        Task task;
+        int idle = 0;
+
+        while (!cancelled()) {
+            if (take(worker, task)) {
+                read(worker, task, buffer, listing);
+                task = Task(); // the parent folder is released
+                m_pending.fetch_sub(1, std::memory_order_acq_rel);
+                idle = 0;
+            } else if (m_pending.load(std::memory_order_acquire) == 0) {
+                break;
+            } else {
+                backoff(idle++);
+            }
+        }
+
+        m_sinks[worker].finish();
+    }
+
+    // The entries of the <task> folder to the sink, its subfolders to the queue of the <worker>
+    void read(int worker, const Task &task, QString &buffer, std::vector<quint64> &listing)
+    {
+        const FolderRef folder = task.folder ? task.folder : openFolder(task);
+        if (!folder)
+            return;
+
+        // joinPath(task.path, name)
+        buffer.resize(0);
+        buffer.append(task.path);
+        if (!endsWithSep(buffer))
+            buffer.append(s_sep);
+        const int base = buffer.size();
+
+        Sink &sink = m_sinks[worker];
+        const bool descend = (m_options.maxDepth < 0 || task.depth < m_options.maxDepth);
+
+        readFolder(*folder, task, listing, [&](const auto &name, WalkEntry::Type type) {
+            setName(buffer, base, name);
+
+            WalkEntry entry;
+            entry.path = QStringView(buffer);
+            entry.name = entry.path.mid(base);
+            entry.depth = task.depth;
+            entry.type = type;
+
+            if (type != WalkEntry::Folder) {
+                if (m_options.files && (!m_options.extensions || m_options.extensions->matches(entry.name)))
+                    sink(entry);
+                return;
+            }
+
+            if (m_options.prune && m_options.prune(entry))
+                return;
+
+            if (m_options.folders)
+                sink(entry);
+
+            if (descend) {
+                Task child;
+                child.parent = folder;
+                child.name = nativeName(name);
+                child.path = entry.path.toString();
+                child.depth = task.depth + 1;
+                push(worker, std::move(child));
+            }
+        });
+    }
+
+    const WalkOptions &m_options;
+    std::vector<Sink> &m_sinks;
+    std::unique_ptr<Queue[]> m_queues;
+    std::atomic<qint64> m_pending { 0 }; // the pushed folders not read yet
+    const std::atomic<bool> *m_cancelled;
+};
+
+template <typename Sink>
+static bool runWalk(const QString &rootFolder, const WalkOptions &options, std::vector<Sink> &sinks,
+                    const std::atomic<bool> *cancelled = nullptr)
+{
+    Walker<Sink> walker(options, sinks, cancelled);
+    return walker.run(rootFolder);
+}
+
+/*** walk() ***/
+struct CallbackSink
+{
+    const std::function<void(const WalkEntry &)> *callback;
+
+    void operator()(const WalkEntry &entry) { (*callback)(entry); }
+    void finish() {}
+};
+
+struct ListSink
+{
+    QStringList paths;
+
+    void operator()(const WalkEntry &entry) { paths.append(entry.path.toString()); }
+    void finish() {}
+};
+
+bool walk(const QString &rootFolder, const std::function<void(const WalkEntry &)> &callback,
+          const WalkOptions &options)
+{
+    std::vector<CallbackSink> sinks(workerCount(options.threads), CallbackSink { &callback });
+    return runWalk(rootFolder, options, sinks);
+}
+
+QStringList walkPaths(const QString &rootFolder, const WalkOptions &options)
+{
+    std::vector<ListSink> sinks(workerCount(options.threads));
+    runWalk(rootFolder, options, sinks);
+
+    int size = 0;
+    for (const ListSink &sink : sinks)
+        size += sink.paths.size();
+
+    QStringList result;
+    result.reserve(size);
+    for (ListSink &sink : sinks)
+        result.append(sink.paths);
+
+    return result;
+}
+
+/*** WalkQueue ***/
+// The entries found by a worker: the paths in one array
+struct WalkBlock
+{
+    struct Item
+    {
+        int start;
+        int size;
+        int nameSize;
+        int depth;
+        WalkEntry::Type type;
+    };
+
+    std::vector<char16_t> data;
+    std::vector<Item> items;
+    WalkBlock *next = nullptr;
+};
+
+static const int s_blockEntries = 256;
+
+// Lock-free: the consumer takes all the published blocks at once, so a block is never popped alone (no ABA)
+static void publish(std::atomic<WalkBlock *> &published, WalkBlock *block)
+{
+    block->next = published.load(std::memory_order_relaxed);
+    while (!published.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+}
+
+static void deleteBlocks(WalkBlock *block)
+{
+    while (block) {
+        WalkBlock *next = block->next;
+        delete block;
+        block = next;
+    }
+}
+
+struct BlockSink
+{
+    std::atomic<WalkBlock *> *published;
+    WalkBlock *block = nullptr;
+
+    void operator()(const WalkEntry &entry)
+    {
+        if (!block)
+            block = new WalkBlock;
+
+        const int start = static_cast<int>(block->data.size());
+        block->data.insert(block->data.end(), entry.path.utf16(), entry.path.utf16() + entry.path.size());
+        block->items.push_back({ start, static_cast<int>(entry.path.size()), static_cast<int>(entry.name.size()),
+                                 entry.depth, entry.type });
+
+        if (static_cast<int>(block->items.size()) == s_blockEntries)
+            finish();
+    }
+
+    void finish()
+    {
+        if (block)
+            publish(*published, block);
+        block = nullptr;
+    }
+};
+
+WalkQueue::WalkQueue(const QString &rootFolder, const WalkOptions &options)
+{
+    m_thread = std::thread([this, rootFolder, options]() {
+        std::vector<BlockSink> sinks(workerCount(options.threads), BlockSink { &m_published });
+        m_ok = runWalk(rootFolder, options, sinks, &m_cancelled);
+        m_finished.store(true, std::memory_order_release);
+    });
+}
+
+WalkQueue::~WalkQueue()
+{
+    m_cancelled.store(true, std::memory_order_relaxed);
+    m_thread.join();
+
+    deleteBlocks(m_block);
+    deleteBlocks(m_published.exchange(nullptr));
+}
+
+// The published blocks in the order of publishing
+WalkBlock *WalkQueue::takeBlocks()
+{
+    WalkBlock *block = m_published.exchange(nullptr, std::memory_order_acquire);
+    WalkBlock *ordered = nullptr;
+
+    while (block) {
+        WalkBlock *next = block->next;
+        block->next = ordered;
+        ordered = block;
+        block = next;
+    }
+
+    return ordered;
+}
+
+bool WalkQueue::next(WalkEntry &entry)
+{
+    int idle = 0;
+
+    while (!m_block || m_index == static_cast<int>(m_block->items.size())) {
+        if (m_block) {
+            WalkBlock *read = m_block;
+            m_block = m_block->next;
+            m_index = 0;
+            delete read;
+            continue;
+        }
+
+        // all blocks are published before the end is
+        const bool finished = m_finished.load(std::memory_order_acquire);
+        m_block = takeBlocks();
+
+        if (!m_block) {
+            if (finished)
+                return false;
+            backoff(idle++);
+        }
+    }
+
+    const WalkBlock::Item &item = m_block->items[m_index++];
+    entry.path = QStringView(m_block->data.data() + item.start, item.size);
+    entry.name = entry.path.right(item.nameSize);
+    entry.depth = item.depth;
+    entry.type = item.type;
+
+    return true;
+}
+
+bool WalkQueue::isOk() const
+{
+    return m_ok;
+}
+
+} // namespace pathstr
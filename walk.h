@@ -0,0 +1,114 @@
+/*
+ ******************************************************************
+ * A small library for handling filesystem paths as strings (Qt). *
+ *                                                                *
+ * artemvlas (at) proton (dot) me                                 *
+ * https://github.com/artemvlas/pathstr                           *
+ ******************************************************************
+ *
+ * MIT License
+ * Copyright (c) 2021 - present Artem Vlasenko
+ */
+
+#ifndef WALK_H
+#define WALK_H
+
+#include <QStringList>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace pathstr {
+class ExtensionSet;
+struct WalkBlock;
+
+/*** Directory walk ***/
+/* The folders are read by <threads> workers, each one takes the subfolders it found
+ * and steals the ones of the others when it runs out. The folders are opened relative
+ * to their parents (openat), the entries are read in large blocks (getdents64 on Linux)
+ * and their types are taken from the folder listing: nothing is stat'ed unless
+ * the file system does not report the types. The paths are built as joinPath(folder, name)
+ * into a buffer of each worker, nothing is allocated for a file.
+ *
+ * The symbolic links are reported, not followed. The unreadable folders are skipped.
+ * The entries come in no particular order, sortPaths() puts them in the path order.
+ */
+struct WalkEntry
+{
+    enum Type { File, Folder, SymLink, Other };
+
+    QStringView path; // joinPath(rootFolder, ...); valid until the callback returns
+    QStringView name; // the last component of the path
+    int depth = 0;    // 0: the entries of the root folder
+    Type type = File;
+
+    bool isFolder() const { return type == Folder; }
+};
+
+struct WalkOptions
+{
+    int threads = 0;   // 0 -> all hardware threads
+    int maxDepth = -1; // the deepest reported entries, -1: no limit; 0: the root folder is not descended
+
+    bool files = true;   // the entries which are not folders are reported
+    bool folders = true; // the folders are reported
+
+    // Only the files with these extensions are reported (ExtensionSet::matches), all folders are walked.
+    // The set must outlive the walk.
+    const ExtensionSet *extensions = nullptr;
+
+    // A folder for which it returns true is neither reported nor descended: "node_modules", ".git"
+    std::function<bool(const WalkEntry &)> prune;
+};
+
+/* Calls the <callback> for every entry under the <rootFolder>. The <callback> and the prune()
+ * are called concurrently by the workers. false if the <rootFolder> can't be opened.
+ *
+ * walk("/home/user/photos", [&](const WalkEntry &entry) { ... });
+ * -> "/home/user/photos/2021", "/home/user/photos/2021/img_0042.jpg", ...
+ */
+bool walk(const QString &rootFolder, const std::function<void(const WalkEntry &)> &callback,
+          const WalkOptions &options = WalkOptions());
+
+// The paths of the entries
+QStringList walkPaths(const QString &rootFolder, const WalkOptions &options = WalkOptions());
+
+/* The walk running in the background, the entries are taken one by one as they are found.
+ * The workers publish them in blocks through a lock-free list, the next() waits for a block.
+ * Destroying the queue stops the walk.
+ *
+ * WalkQueue queue("/home/user");
+ * WalkEntry entry;
+ * while (queue.next(entry))
+ *     ...
+ */
+class WalkQueue
+{
+public:
+    explicit WalkQueue(const QString &rootFolder, const WalkOptions &options = WalkOptions());
+    ~WalkQueue();
+
+    WalkQueue(const WalkQueue &) = delete;
+    WalkQueue &operator=(const WalkQueue &) = delete;
+
+    // The next entry, false at the end of the walk. The views are valid until the next call.
+    bool next(WalkEntry &entry);
+
+    // false if the root folder can't be opened; known when next() returns false
+    bool isOk() const;
+
+private:
+    WalkBlock *takeBlocks();
+
+    std::atomic<WalkBlock *> m_published { nullptr }; // the last published first
+    std::atomic<bool> m_finished { false };
+    std::atomic<bool> m_cancelled { false };
+    bool m_ok = true;
+    WalkBlock *m_block = nullptr;                     // being read, then the next ones in order
+    int m_index = 0;
+    std::thread m_thread;
+};
+
+} // namespace pathstr
+
+#endif // WALK_H